@@ -0,0 +1,424 @@
+// Bench.cpp
+// Headless microbenchmarks for the simulation hot paths.
+// Prints one CSV row per (benchmark, map size) so results can be diffed per commit:
+//   label,bench,width,height,iterations,ns_per_op,ops_per_sec,allocs_per_op
+//
+//   --filter <text>   only run benchmarks whose name contains <text>
+//   --min-ms <n>      minimum measured time per row (default 200)
+//   --label <text>    value for the label column (e.g. a commit hash)
+//   --out <file>      write the CSV to <file> instead of stdout
+//   --threads <n>     VecWorld worker threads for the vec rows (default 1)
+#include "../include/AllocStats.hpp"
+#include "../include/Bitboard.hpp"
+#include "../include/VecWorld.hpp"
+#include "../include/World.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct MapSize {
+    int width;
+    int height;
+};
+
+constexpr MapSize kMapSizes[] = {
+    { 32, 18 }, { 64, 36 }, { 128, 128 }, { 256, 256 }, { 512, 512 }, { 1024, 1024 },
+};
+
+// Results are folded into this so the optimizer cannot drop the work
+volatile std::uint64_t sink = 0;
+
+int vecThreads = 1; // --threads
+constexpr int kVecMatches = 256;
+
+// --- World setups; the match never times out so no row pays for a reset ---
+
+// Rules as shipped, but no spawns and no move cooldown: one step per tick
+WorldConfig isolatedConfig(MapSize size) {
+    WorldConfig c;
+    c.width = size.width;
+    c.height = size.height;
+    c.gameDurationSec = 1 << 30;
+    c.spawnIntervalTicks = 1 << 30;
+    c.moveIntervalTicks = 1;
+    return c;
+}
+
+WorldConfig spawnEveryTickConfig(MapSize size) {
+    WorldConfig c = isolatedConfig(size);
+    c.spawnIntervalTicks = 1;
+    return c;
+}
+
+// Shipped pacing: move cooldown and a spawn every 2 s
+WorldConfig shippedConfig(MapSize size) {
+    WorldConfig c = WorldConfig::forTickRate(60);
+    c.width = size.width;
+    c.height = size.height;
+    c.gameDurationSec = 1 << 30;
+    return c;
+}
+
+// Training pacing: a step every tick, shipped spawns and match length, so
+// matches end and restart inside long runs
+WorldConfig trainingConfig(MapSize size) {
+    WorldConfig c = WorldConfig::forTickRate(60);
+    c.width = size.width;
+    c.height = size.height;
+    c.moveIntervalTicks = 1;
+    return c;
+}
+
+Inputs stepOf(int dx, int dy) {
+    Inputs in;
+    in.player[0].dx = dx;
+    in.player[0].dy = dy;
+    return in;
+}
+
+// --- Benchmarks: a setup builds the scenario once, untimed; the body then
+// runs 'iterations' operations on it ---
+
+template <class WorldT>
+void noSetup(WorldT&) {}
+
+// P1 walks back and forth along the empty top row
+template <class WorldT>
+void setupMove(WorldT& world) {
+    world.placePlayer(0, 1, 0);
+}
+
+template <class WorldT>
+void benchMove(WorldT& world, long iterations) {
+    const Inputs right = stepOf(1, 0);
+    const Inputs left = stepOf(-1, 0);
+    for (long i = 0; i < iterations; ++i) {
+        world.step((i & 1) ? left : right);
+    }
+    sink = sink + static_cast<std::uint64_t>(world.player(0).x);
+}
+
+// P1 shoves a box along the top row, restarting at the left edge when it hits the wall
+template <class WorldT>
+void benchPush(WorldT& world, long iterations) {
+    const int w = world.width();
+    const Inputs right = stepOf(1, 0);
+    int boxX = w;
+    for (long i = 0; i < iterations; ++i) {
+        if (boxX >= w - 1) {
+            world.setTileAt(w - 1, 0, TileType::Floor);
+            world.setTileAt(1, 0, TileType::PushableBox);
+            world.placePlayer(0, 0, 0);
+            boxX = 1;
+        }
+        world.step(right);
+        ++boxX;
+    }
+    sink = sink + static_cast<std::uint64_t>(world.player(0).x);
+}
+
+// P1 pushes a box into a portal; the box is put back each time. Placing the
+// portal rebuilds the deadlock tables (O(cells)), so it is setup, not an op.
+template <class WorldT>
+void setupPortal(WorldT& world) {
+    world.setTileAt(3, 0, TileType::Portal);
+}
+
+template <class WorldT>
+void benchPortal(WorldT& world, long iterations) {
+    const Inputs right = stepOf(1, 0);
+    for (long i = 0; i < iterations; ++i) {
+        world.placePlayer(0, 1, 0);
+        world.setTileAt(2, 0, TileType::PushableBox);
+        world.step(right);
+    }
+    sink = sink + static_cast<std::uint64_t>(world.player(0).score);
+}
+
+// P1 at the top-left corner alternately walks into the left edge and pushes a
+// box into the top edge: both are refused by the border, the bounds checks the
+// sentinel ring replaced
+template <class WorldT>
+void setupEdge(WorldT& world) {
+    world.placePlayer(0, 0, 1);
+    world.setTileAt(0, 0, TileType::PushableBox);
+}
+
+template <class WorldT>
+void benchEdge(WorldT& world, long iterations) {
+    const Inputs left = stepOf(-1, 0);
+    const Inputs up = stepOf(0, -1);
+    for (long i = 0; i < iterations; ++i) {
+        world.step((i & 1) ? up : left);
+    }
+    sink = sink + static_cast<std::uint64_t>(world.player(0).y);
+}
+
+// One spawn per tick until the board is full, then the level is reset
+template <class WorldT>
+void benchSpawn(WorldT& world, long iterations) {
+    const Inputs idle;
+    for (long i = 0; i < iterations; ++i) {
+        if (world.freeCellCount() == 0) world.reset();
+        world.step(idle);
+    }
+    sink = sink + static_cast<std::uint64_t>(world.freeCellCount());
+}
+
+// Level rebuild: where per-tile objects used to be allocated and freed in bulk.
+// allocs_per_op must stay 0 here; the grid is one buffer reused across resets.
+template <class WorldT>
+void benchReset(WorldT& world, long iterations) {
+    for (long i = 0; i < iterations; ++i) {
+        world.reset();
+    }
+    sink = sink + static_cast<std::uint64_t>(world.freeCellCount());
+}
+
+// Shipped pacing, both players mashing random directions, changed-cell list
+// drained every tick like the renderer does
+template <class WorldT>
+void benchTick(WorldT& world, long iterations) {
+    Rng inputRng(0xBE7C);
+    for (long i = 0; i < iterations; ++i) {
+        Inputs in;
+        for (PlayerInput& p : in.player) {
+            switch (inputRng.below(5)) {
+                case 0: p.dx = 1; break;
+                case 1: p.dx = -1; break;
+                case 2: p.dy = 1; break;
+                case 3: p.dy = -1; break;
+                default: break;
+            }
+        }
+        world.step(in);
+        world.clearChangedCells();
+    }
+    sink = sink + static_cast<std::uint64_t>(world.player(0).score + world.player(1).score);
+}
+
+// A mid-match board: roughly one floor cell in four holds a pushable box
+void setupScattered(World& world) {
+    Rng boxRng(0xB0C5);
+    for (int y = 0; y < world.height(); ++y) {
+        for (int x = 0; x < world.width(); ++x) {
+            const bool underPlayer = (world.player(0).x == x && world.player(0).y == y) ||
+                                     (world.player(1).x == x && world.player(1).y == y);
+            if (!underPlayer && world.tileAt(x, y) == TileType::Floor && boxRng.below(4) == 0) {
+                world.setTileAt(x, y, TileType::PushableBox);
+            }
+        }
+    }
+}
+
+// Search buffers for reach-grid and the bitboard for the *-bits rows, built by
+// their setups
+std::vector<std::uint8_t> seen;
+std::vector<int> queue;
+BitboardState32x18 bits;
+
+// P1's walkable region by breadth-first search over tiles, the per-cell baseline
+// for reach-bits. The buffers are sized in setup, so the timed loop does not allocate.
+void setupReachGrid(World& world) {
+    setupScattered(world);
+    const std::size_t cells = static_cast<std::size_t>(world.stride() * (world.height() + 2));
+    seen.assign(cells, 0);
+    queue.assign(cells, 0);
+}
+
+void benchReachGrid(World& world, long iterations) {
+    const int stride = world.stride();
+    const int blockedCell = world.cellAt(world.player(1).x, world.player(1).y);
+    const TileType* tiles = world.tileData(); // bordered: the ring stops the search
+    for (long i = 0; i < iterations; ++i) {
+        std::fill(seen.begin(), seen.end(), 0);
+        int head = 0;
+        int tail = 0;
+        const int start = world.cellAt(world.player(0).x, world.player(0).y);
+        queue[tail++] = start;
+        seen[static_cast<std::size_t>(start)] = 1;
+        while (head < tail) {
+            const int cell = queue[head++];
+            const int next[4] = { cell - stride, cell + stride, cell - 1, cell + 1 };
+            for (int n : next) {
+                if (seen[static_cast<std::size_t>(n)] || n == blockedCell) continue;
+                if (!traitsOf(tiles[n]).walkable) continue;
+                seen[static_cast<std::size_t>(n)] = 1;
+                queue[tail++] = n;
+            }
+        }
+        sink = sink + static_cast<std::uint64_t>(tail);
+    }
+}
+
+// The scattered board as a bitboard (these rows only run at 32x18)
+void setupBits(World& world) {
+    setupScattered(world);
+    BitboardState32x18::fromWorld(world, bits);
+}
+
+// The same region as reach-grid, by whole-board shift-and-mask flood fill
+void benchReachBits(World&, long iterations) {
+    for (long i = 0; i < iterations; ++i) {
+        sink = sink + static_cast<std::uint64_t>(bits.reachable(0).count());
+    }
+}
+
+// Reachable region plus every legal push from it, in all four directions
+void benchPushesBits(World&, long iterations) {
+    for (long i = 0; i < iterations; ++i) {
+        const Bitboard32x18 region = bits.reachable(0);
+        int pushes = 0;
+        for (int dir = 0; dir < 4; ++dir) pushes += bits.pushable(dir, region).count();
+        sink = sink + static_cast<std::uint64_t>(pushes);
+    }
+}
+
+struct Measurement {
+    long iterations = 0;
+    double seconds = 0.0;
+    std::uint64_t allocations = 0;
+};
+
+// One timed batch on a fresh world: the runtime-sized World or a FixedBoard
+// specialization, so the same benchmark body measures both. Setup and warm-up
+// run before the clock starts, so ns_per_op does not depend on the batch size.
+template <class WorldT, void (*Setup)(WorldT&), void (*Run)(WorldT&, long)>
+Measurement timedBatch(const WorldConfig& config, long iterations) {
+    using Clock = std::chrono::steady_clock;
+    WorldT world(config);
+    Setup(world);
+    Run(world, 16); // warm-up
+
+    const allocstats::Snapshot before = allocstats::current();
+    const Clock::time_point start = Clock::now();
+    Run(world, iterations);
+    Measurement m;
+    m.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    m.allocations = allocstats::since(before).allocations;
+    m.iterations = iterations;
+    return m;
+}
+
+// kVecMatches matches stepped together with random actions; one op is one
+// match-step, so ns_per_op compares directly with the tick rows
+template <class VecT>
+Measurement timedVecBatch(const WorldConfig& config, long iterations) {
+    using Clock = std::chrono::steady_clock;
+    VecT batch(kVecMatches, config, vecThreads);
+    Rng actionRng(0xAC7);
+    auto run = [&](long steps) {
+        std::uint8_t* actions = batch.actions();
+        for (long s = 0; s < steps; ++s) {
+            for (int a = 0; a < kVecMatches * 2; ++a) actions[a] = static_cast<std::uint8_t>(actionRng.below(5));
+            batch.step();
+            sink = sink + static_cast<std::uint64_t>(batch.rewards()[0] + batch.dones()[0]);
+        }
+    };
+    run(4); // warm-up outside the timed region
+
+    const long steps = std::max(1L, iterations / kVecMatches);
+    const allocstats::Snapshot before = allocstats::current();
+    const Clock::time_point start = Clock::now();
+    run(steps);
+    Measurement m;
+    m.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    m.allocations = allocstats::since(before).allocations;
+    m.iterations = steps * kVecMatches;
+    return m;
+}
+
+struct Benchmark {
+    const char* name;
+    WorldConfig (*config)(MapSize);
+    Measurement (*batch)(const WorldConfig&, long);
+    bool shippedSizeOnly = false; // fixed-size code paths (World32x18, Bitboard32x18)
+};
+
+// "-fixed" rows repeat a benchmark on the compile-time 32x18 board
+constexpr Benchmark kBenchmarks[] = {
+    { "move",         isolatedConfig,       timedBatch<World, setupMove<World>, benchMove<World>> },
+    { "push",         isolatedConfig,       timedBatch<World, noSetup<World>, benchPush<World>> },
+    { "portal",       isolatedConfig,       timedBatch<World, setupPortal<World>, benchPortal<World>> },
+    { "edge",         isolatedConfig,       timedBatch<World, setupEdge<World>, benchEdge<World>> },
+    { "spawn",        spawnEveryTickConfig, timedBatch<World, noSetup<World>, benchSpawn<World>> },
+    { "reset",        isolatedConfig,       timedBatch<World, noSetup<World>, benchReset<World>> },
+    { "tick",         shippedConfig,        timedBatch<World, noSetup<World>, benchTick<World>> },
+    { "move-fixed",   isolatedConfig,       timedBatch<World32x18, setupMove<World32x18>, benchMove<World32x18>>,      true },
+    { "push-fixed",   isolatedConfig,       timedBatch<World32x18, noSetup<World32x18>, benchPush<World32x18>>,        true },
+    { "portal-fixed", isolatedConfig,       timedBatch<World32x18, setupPortal<World32x18>, benchPortal<World32x18>>,  true },
+    { "edge-fixed",   isolatedConfig,       timedBatch<World32x18, setupEdge<World32x18>, benchEdge<World32x18>>,      true },
+    { "spawn-fixed",  spawnEveryTickConfig, timedBatch<World32x18, noSetup<World32x18>, benchSpawn<World32x18>>,       true },
+    { "reset-fixed",  isolatedConfig,       timedBatch<World32x18, noSetup<World32x18>, benchReset<World32x18>>,       true },
+    { "tick-fixed",   shippedConfig,        timedBatch<World32x18, noSetup<World32x18>, benchTick<World32x18>>,        true },
+    { "vec",          trainingConfig,       timedVecBatch<VecWorld>,                                                   true },
+    { "vec-fixed",    trainingConfig,       timedVecBatch<VecWorld32x18>,                                              true },
+    { "reach-grid",   isolatedConfig,       timedBatch<World, setupReachGrid, benchReachGrid>,                         true },
+    { "reach-bits",   isolatedConfig,       timedBatch<World, setupBits, benchReachBits>,                              true },
+    { "pushes-bits",  isolatedConfig,       timedBatch<World, setupBits, benchPushesBits>,                             true },
+};
+
+// Double the batch until it runs for at least minSeconds; the world is rebuilt per batch
+Measurement measure(const Benchmark& bench, MapSize size, double minSeconds) {
+    const WorldConfig config = bench.config(size);
+    for (long iterations = 64; ; iterations *= 2) {
+        const Measurement m = bench.batch(config, iterations);
+        if (m.seconds >= minSeconds) return m;
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const char* filter = nullptr;
+    const char* label = "local";
+    const char* outPath = nullptr;
+    double minSeconds = 0.2;
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--filter") == 0 && hasValue) {
+            filter = argv[++i];
+        } else if (std::strcmp(argv[i], "--min-ms") == 0 && hasValue) {
+            minSeconds = std::atoi(argv[++i]) / 1000.0;
+        } else if (std::strcmp(argv[i], "--label") == 0 && hasValue) {
+            label = argv[++i];
+        } else if (std::strcmp(argv[i], "--out") == 0 && hasValue) {
+            outPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--threads") == 0 && hasValue) {
+            vecThreads = std::atoi(argv[++i]);
+        } else {
+            std::fprintf(stderr, "usage: %s [--filter text] [--min-ms n] [--label text] [--out file] [--threads n]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    std::FILE* out = outPath ? std::fopen(outPath, "w") : stdout;
+    if (!out) {
+        std::fprintf(stderr, "Could not open %s\n", outPath);
+        return 1;
+    }
+
+    std::fprintf(out, "label,bench,width,height,iterations,ns_per_op,ops_per_sec,allocs_per_op\n");
+    for (const Benchmark& bench : kBenchmarks) {
+        if (filter && !std::strstr(bench.name, filter)) continue;
+        for (MapSize size : kMapSizes) {
+            if (bench.shippedSizeOnly && (size.width != 32 || size.height != 18)) continue;
+            const Measurement m = measure(bench, size, minSeconds);
+            const double nsPerOp = m.seconds * 1e9 / static_cast<double>(m.iterations);
+            std::fprintf(out, "%s,%s,%d,%d,%ld,%.2f,%.0f,%.4f\n", label, bench.name, size.width, size.height,
+                         m.iterations, nsPerOp, 1e9 / nsPerOp,
+                         static_cast<double>(m.allocations) / static_cast<double>(m.iterations));
+            std::fflush(out);
+        }
+    }
+
+    if (out != stdout) std::fclose(out);
+    return 0;
+}
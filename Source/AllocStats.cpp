@@ -0,0 +1,42 @@
+// AllocStats.cpp
+#include "../include/AllocStats.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+std::atomic<std::uint64_t> gAllocations{0};
+std::atomic<std::uint64_t> gFrees{0};
+std::atomic<std::uint64_t> gBytes{0};
+
+void* countedAlloc(std::size_t size) {
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    gBytes.fetch_add(size, std::memory_order_relaxed);
+    if (size == 0) size = 1;
+    if (void* p = std::malloc(size)) return p;
+    throw std::bad_alloc();
+}
+
+void countedFree(void* p) {
+    if (!p) return;
+    gFrees.fetch_add(1, std::memory_order_relaxed);
+    std::free(p);
+}
+} // namespace
+
+allocstats::Snapshot allocstats::current() {
+    Snapshot s;
+    s.allocations = gAllocations.load(std::memory_order_relaxed);
+    s.frees = gFrees.load(std::memory_order_relaxed);
+    s.bytes = gBytes.load(std::memory_order_relaxed);
+    return s;
+}
+
+// --- Global replacements (aligned overloads keep the library defaults) ---
+void* operator new(std::size_t size) { return countedAlloc(size); }
+void* operator new[](std::size_t size) { return countedAlloc(size); }
+void operator delete(void* p) noexcept { countedFree(p); }
+void operator delete[](void* p) noexcept { countedFree(p); }
+void operator delete(void* p, std::size_t) noexcept { countedFree(p); }
+void operator delete[](void* p, std::size_t) noexcept { countedFree(p); }
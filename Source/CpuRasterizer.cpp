@@ -0,0 +1,139 @@
+// CpuRasterizer.cpp
+#include "../include/CpuRasterizer.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+namespace {
+// 3x5 glyphs, one row per 3 bits (MSB = left column), top row first
+struct Glyph {
+    char c;
+    std::uint8_t rows[5];
+};
+
+const Glyph kFont[] = {
+    {'0', {7, 5, 5, 5, 7}}, {'1', {2, 6, 2, 2, 7}}, {'2', {7, 1, 7, 4, 7}}, {'3', {7, 1, 7, 1, 7}},
+    {'4', {5, 5, 7, 1, 1}}, {'5', {7, 4, 7, 1, 7}}, {'6', {7, 4, 7, 5, 7}}, {'7', {7, 1, 1, 1, 1}},
+    {'8', {7, 5, 7, 5, 7}}, {'9', {7, 5, 7, 1, 7}}, {':', {0, 2, 0, 2, 0}}, {'!', {2, 2, 2, 0, 2}},
+    {'A', {2, 5, 7, 5, 5}}, {'D', {6, 5, 5, 5, 6}}, {'E', {7, 4, 6, 4, 7}}, {'I', {7, 2, 2, 2, 7}},
+    {'L', {4, 4, 4, 4, 7}}, {'N', {6, 5, 5, 5, 5}}, {'P', {7, 5, 7, 4, 4}}, {'R', {6, 5, 6, 5, 5}},
+    {'S', {3, 4, 2, 1, 6}}, {'W', {5, 5, 5, 7, 5}}, {'Y', {5, 5, 2, 2, 2}},
+};
+
+const Glyph* findGlyph(char c) {
+    for (const Glyph& g : kFont) {
+        if (g.c == c) return &g;
+    }
+    return nullptr; // space and anything unknown
+}
+} // namespace
+
+CpuRasterizer::CpuRasterizer(const TextureAtlas& atlas, int mapW, int mapH, float tile)
+: atlas(atlas)
+, mapW(mapW)
+, mapH(mapH)
+, tile(tile)
+, w(static_cast<unsigned>(mapW * tile))
+, h(static_cast<unsigned>(mapH * tile))
+, buffer(static_cast<std::size_t>(w) * h * 4, 0)
+{
+}
+
+void CpuRasterizer::fillRect(int x, int y, int rw, int rh, Rgba color) {
+    const int x0 = std::max(0, x), y0 = std::max(0, y);
+    const int x1 = std::min(static_cast<int>(w), x + rw), y1 = std::min(static_cast<int>(h), y + rh);
+    for (int py = y0; py < y1; ++py) {
+        std::uint8_t* p = &buffer[(static_cast<std::size_t>(py) * w + static_cast<std::size_t>(x0)) * 4];
+        for (int px = x0; px < x1; ++px, p += 4) {
+            p[0] = color.r; p[1] = color.g; p[2] = color.b; p[3] = color.a;
+        }
+    }
+}
+
+// Scale an atlas cell to size x size pixels at (x, y); alpha 0 texels are skipped
+void CpuRasterizer::blit(AtlasImage image, int x, int y, int size) {
+    const sf::IntRect r = atlas.rect(image);
+    const std::uint8_t* src = atlas.image().getPixelsPtr();
+    const unsigned atlasW = atlas.image().getSize().x;
+    for (int dy = 0; dy < size; ++dy) {
+        const int py = y + dy;
+        if (py < 0 || py >= static_cast<int>(h)) continue;
+        const int sy = r.position.y + dy * r.size.y / size;
+        for (int dx = 0; dx < size; ++dx) {
+            const int px = x + dx;
+            if (px < 0 || px >= static_cast<int>(w)) continue;
+            const int sx = r.position.x + dx * r.size.x / size;
+            const std::uint8_t* s = &src[(static_cast<std::size_t>(sy) * atlasW + static_cast<std::size_t>(sx)) * 4];
+            if (s[3] == 0) continue;
+            std::memcpy(&buffer[(static_cast<std::size_t>(py) * w + static_cast<std::size_t>(px)) * 4], s, 4);
+        }
+    }
+}
+
+int CpuRasterizer::textWidth(const char* text, int scale) {
+    return static_cast<int>(std::strlen(text)) * 4 * scale;
+}
+
+void CpuRasterizer::drawText(const char* text, int x, int y, int scale, Rgba color) {
+    for (const char* c = text; *c; ++c, x += 4 * scale) {
+        const Glyph* g = findGlyph(*c);
+        if (!g) continue;
+        for (int row = 0; row < 5; ++row) {
+            for (int col = 0; col < 3; ++col) {
+                if (g->rows[row] & (4 >> col)) fillRect(x + col * scale, y + row * scale, scale, scale, color);
+            }
+        }
+    }
+}
+
+void CpuRasterizer::render(const World& world) {
+    const int t = static_cast<int>(tile);
+    fillRect(0, 0, static_cast<int>(w), static_cast<int>(h), {0, 0, 0, 255});
+
+    // --- Board: checkerboard floor (1px grid), then boxes/portals from the atlas ---
+    const TileType* cells = world.tileData();
+    for (int y = 0; y < mapH; ++y) {
+        const TileType* row = cells + world.cellAt(0, y);
+        for (int x = 0; x < mapW; ++x) {
+            bool dark = ((x + y) % 2) == 0;
+            fillRect(x * t, y * t, t - 1, t - 1, dark ? Rgba{220, 226, 234, 255} : Rgba{240, 244, 248, 255});
+            switch (row[x]) {
+                case TileType::Box:         blit(AtlasImage::SpecialBox, x * t, y * t, t - 4); break;
+                case TileType::PushableBox: blit(AtlasImage::Box, x * t, y * t, t - 4); break;
+                case TileType::Portal:      blit(AtlasImage::Portal, x * t, y * t, t - 1); break;
+                default: break;
+            }
+        }
+    }
+
+    // --- Players ---
+    blit(AtlasImage::Player1, world.player(0).x * t + 2, world.player(0).y * t + 2, t - 4);
+    blit(AtlasImage::Player2, world.player(1).x * t + 2, world.player(1).y * t + 2, t - 4);
+
+    // --- HUD (same layout as Hud) ---
+    char buf[32];
+    const int scale = 4;
+    std::memcpy(buf, "PLAYER 1: ", 10);
+    *std::to_chars(buf + 10, buf + 31, world.player(0).score).ptr = '\0';
+    drawText(buf, 10, 10, scale, {255, 0, 0, 255});
+    buf[7] = '2';
+    *std::to_chars(buf + 10, buf + 31, world.player(1).score).ptr = '\0';
+    drawText(buf, static_cast<int>(w) - textWidth(buf, scale) - 10, 10, scale, {0, 0, 255, 255}); // right-aligned
+
+    const int remaining = world.remainingSeconds();
+    const int minutes = remaining / 60, seconds = remaining % 60;
+    const char clock[] = { static_cast<char>('0' + minutes / 10), static_cast<char>('0' + minutes % 10), ':',
+                           static_cast<char>('0' + seconds / 10), static_cast<char>('0' + seconds % 10), '\0' };
+    drawText(clock, static_cast<int>(w / 2) - 40, 10, scale, {0, 0, 0, 255});
+
+    if (world.isGameOver()) {
+        const char* banner = world.winner() == 1 ? "PLAYER 1 WINS!" : world.winner() == 2 ? "PLAYER 2 WINS!" : "DRAW!";
+        drawText(banner, static_cast<int>(w / 2) - 150, static_cast<int>(h / 2) - 40, 8, {0, 0, 0, 255});
+    }
+}
+
+bool CpuRasterizer::savePng(const std::string& path) const {
+    sf::Image image({w, h}, buffer.data());
+    return image.saveToFile(path);
+}
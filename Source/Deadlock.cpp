@@ -0,0 +1,146 @@
+// Deadlock.cpp
+#include "../include/Deadlock.hpp"
+
+#include <algorithm>
+
+int CellBitset::count() const {
+    int n = 0;
+    for (std::uint64_t w : words) {
+        for (; w; w &= w - 1) ++n;
+    }
+    return n;
+}
+
+// A singly linked list on the recursion's stack: no allocation, and each
+// frame only sees the boxes above it
+struct DeadlockTable::Pin {
+    int cell;
+    const Pin* next;
+};
+
+namespace {
+
+constexpr int kDirX[4] = { 0, 0, -1, 1 };
+constexpr int kDirY[4] = { -1, 1, 0, 0 };
+
+} // namespace
+
+void DeadlockTable::build(int width, int height, const std::uint8_t* board) {
+    const int count = width * height;
+    if (width == boardWidth && height == boardHeight && std::equal(board, board + count, flags.begin())) {
+        return; // same static layout (every reset() of an unedited level): skip the pull search
+    }
+    boardWidth = width;
+    boardHeight = height;
+    flags.assign(board, board + count);
+    queue.resize(static_cast<std::size_t>(count));
+    dead.resize(count);
+    dead.fill();
+
+    // Pull boxes away from every goal at once. A box at 'from' pushed towards
+    // 'to' needs 'from' open and room for the player behind it. The queue holds
+    // packed (y << 16 | x) so the loop needs no division.
+    int head = 0;
+    int tail = 0;
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            const int c = y * width + x;
+            if ((flags[static_cast<std::size_t>(c)] & (kWall | kGoal)) != kGoal) continue;
+            dead.reset(c);
+            queue[static_cast<std::size_t>(tail++)] = y << 16 | x;
+        }
+    }
+    while (head < tail) {
+        const int packed = queue[static_cast<std::size_t>(head++)];
+        const int x = packed & 0xFFFF;
+        const int y = packed >> 16;
+        for (int d = 0; d < 4; ++d) {
+            const int fx = x - kDirX[d];
+            const int fy = y - kDirY[d];
+            if (isBlocked(fx, fy) || isBlocked(fx - kDirX[d], fy - kDirY[d])) continue;
+            const int from = fy * width + fx;
+            if (!dead.test(from)) continue; // already reached
+            dead.reset(from);
+            queue[static_cast<std::size_t>(tail++)] = fy << 16 | fx;
+        }
+    }
+    live = tail;
+}
+
+bool DeadlockTable::isBlocked(int x, int y) const {
+    if (x < 0 || y < 0 || x >= boardWidth || y >= boardHeight) return true;
+    return (flags[static_cast<std::size_t>(y * boardWidth + x)] & kWall) != 0;
+}
+
+struct DeadlockTable::FreezeQuery {
+    const CellBitset& boxes;
+    const CellBitset* known;
+    int budget;
+};
+
+bool DeadlockTable::isFrozen(const CellBitset& boxes, int cell, const CellBitset* known) const {
+    FreezeQuery q{ boxes, known, kFreezeBudget };
+    bool offGoal = false;
+    return frozen(q, cell % boardWidth, cell / boardWidth, nullptr, offGoal);
+}
+
+bool DeadlockTable::isFreezeDeadlock(const CellBitset& boxes, int cell) const {
+    FreezeQuery q{ boxes, nullptr, kFreezeBudget };
+    bool offGoal = false;
+    return frozen(q, cell % boardWidth, cell / boardWidth, nullptr, offGoal) && offGoal;
+}
+
+// Blocked on both axes. Neighbor boxes are tested with this box pinned as a
+// wall, which is what makes two boxes side by side against a wall freeze
+// each other. 'offGoal' only collects boxes of a group that did freeze.
+bool DeadlockTable::frozen(FreezeQuery& q, int x, int y, const Pin* pinned, bool& offGoal) const {
+    if (--q.budget < 0) return false;
+    const int cell = y * boardWidth + x;
+    const Pin self{ cell, pinned };
+    bool groupOffGoal = (flags[static_cast<std::size_t>(cell)] & kGoal) == 0;
+
+    auto isPinned = [pinned, &q](int c) {
+        if (q.known && q.known->test(c)) return true;
+        for (const Pin* p = pinned; p; p = p->next) {
+            if (p->cell == c) return true;
+        }
+        return false;
+    };
+
+    // Classify both axes before recursing: one axis that is plainly free (no
+    // wall, no dead pair, no box on either side) settles it without any search.
+    // d = 0 is the vertical axis (up/down), d = 2 the horizontal one (left/right).
+    int sides[2][2];
+    bool open[2];
+    for (int axis = 0; axis < 2; ++axis) {
+        const int d = axis * 2;
+        open[axis] = false;
+        if (isBlocked(x + kDirX[d], y + kDirY[d]) || isBlocked(x + kDirX[d + 1], y + kDirY[d + 1])) continue;
+        const int a = cell + kDirX[d] + kDirY[d] * boardWidth;
+        const int b = cell + kDirX[d + 1] + kDirY[d + 1] * boardWidth;
+        if (isPinned(a) || isPinned(b)) continue;
+        if (dead.test(a) && dead.test(b)) continue; // either push leaves it on a dead square
+        if (!q.boxes.test(a) && !q.boxes.test(b)) return false;
+        sides[axis][0] = a;
+        sides[axis][1] = b;
+        open[axis] = true; // blocked only if a neighbor box turns out frozen
+    }
+
+    for (int axis = 0; axis < 2; ++axis) {
+        if (!open[axis]) continue;
+        bool blocked = false;
+        for (int k = 0; k < 2; ++k) {
+            const int side = sides[axis][k];
+            const int d = axis * 2 + k;
+            bool sideOffGoal = false;
+            if (q.boxes.test(side) && frozen(q, x + kDirX[d], y + kDirY[d], &self, sideOffGoal)) {
+                groupOffGoal = groupOffGoal || sideOffGoal;
+                blocked = true;
+                break;
+            }
+        }
+        if (!blocked) return false; // free to move along this axis
+    }
+    offGoal = offGoal || groupOffGoal;
+    return true;
+}
@@ -0,0 +1,56 @@
+// GameView.cpp
+#include "../include/GameView.hpp"
+#include "../include/Trace.hpp"
+
+GameView::GameView(const TextureAtlas& atlas, const sf::Font& font, int mapW, int mapH, float tile)
+: tile(tile)
+, size(static_cast<unsigned>(mapW * tile), static_cast<unsigned>(mapH * tile))
+, boardView(tile, atlas.texture())
+, hudView(font, mapW * tile, mapH * tile, tile)
+, player1(atlas.texture(), atlas.rect(AtlasImage::Player1))
+, player2(atlas.texture(), atlas.rect(AtlasImage::Player2))
+{
+    // --- Board: per-kind render data ---
+    boardView.setStyle(TileType::Floor, atlas.rect(AtlasImage::White), tile - 1.f);
+    boardView.setStyle(TileType::Box, atlas.rect(AtlasImage::SpecialBox), tile - 4.f);
+    boardView.setStyle(TileType::PushableBox, atlas.rect(AtlasImage::Box), tile - 4.f);
+    boardView.setStyle(TileType::Portal, atlas.rect(AtlasImage::Portal), tile - 1.f);
+
+    // --- Players: P1 (WASD) and P2 (arrow keys), sprites cut from the atlas ---
+    float desiredSize = tile - 4.f;
+    const float playerScale = desiredSize / static_cast<float>(TextureAtlas::kCellSize);
+    player1.setScale(sf::Vector2f(playerScale, playerScale));
+    player2.setScale(sf::Vector2f(playerScale, playerScale));
+}
+
+void GameView::update(World& world, const PlayerState prev[2], float alpha, Profiler* profiler) {
+    // update sprite pixel positions, blended between the previous and current tick
+    auto lerpPos = [&](const PlayerState& a, const PlayerState& b) {
+        return sf::Vector2f((a.x + (b.x - a.x) * alpha) * tile + 2.f,
+                            (a.y + (b.y - a.y) * alpha) * tile + 2.f);
+    };
+    player1.setPosition(lerpPos(prev[0], world.player(0)));
+    player2.setPosition(lerpPos(prev[1], world.player(1)));
+
+    // Update HUD (no-op unless a score, the shown second or the match state changed)
+    {
+        ScopedTimer timer(profiler, Phase::Hud);
+        TRACE_SCOPE("hud update");
+        hudView.update(world);
+    }
+
+    {
+        ScopedTimer timer(profiler, Phase::Board);
+        boardView.sync(world);
+        world.clearChangedCells();
+    }
+}
+
+void GameView::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+    target.draw(boardView, states);
+    target.draw(player1, states);
+    target.draw(player2, states);
+
+    // Scores, timer and (after the match) the winner banner
+    target.draw(hudView, states);
+}
@@ -0,0 +1,108 @@
+// Hud.cpp
+#include "../include/Hud.hpp"
+#include "../include/Trace.hpp"
+
+#include <charconv>
+#include <chrono>
+#include <cstring>
+
+namespace {
+// "<prefix><value>" into buf without touching the heap
+const char* formatScore(char (&buf)[32], const char* prefix, int value) {
+    std::size_t n = std::strlen(prefix);
+    std::memcpy(buf, prefix, n);
+    char* end = std::to_chars(buf + n, buf + sizeof(buf) - 1, value).ptr;
+    *end = '\0';
+    return buf;
+}
+
+// "MM:SS"
+const char* formatClock(char (&buf)[32], int totalSeconds) {
+    int minutes = totalSeconds / 60;
+    int seconds = totalSeconds % 60;
+    char* p = buf;
+    if (minutes < 10) *p++ = '0';
+    p = std::to_chars(p, buf + sizeof(buf) - 4, minutes).ptr;
+    *p++ = ':';
+    *p++ = static_cast<char>('0' + seconds / 10);
+    *p++ = static_cast<char>('0' + seconds % 10);
+    *p = '\0';
+    return buf;
+}
+} // namespace
+
+Hud::Hud(const sf::Font& font, float width, float height, float tileSize)
+: player1ScoreText(font)
+, player2ScoreText(font)
+, timerText(font)
+, winnerText(font)
+{
+    player1ScoreText.setCharacterSize(24);
+    player1ScoreText.setFillColor(sf::Color::Red);
+    player1ScoreText.setPosition(sf::Vector2f(10, 10));
+
+    player2ScoreText.setCharacterSize(24);
+    player2ScoreText.setFillColor(sf::Color::Blue);
+    player2ScoreText.setPosition(sf::Vector2f(width - tileSize * 4, 10));
+
+    timerText.setCharacterSize(24);
+    timerText.setFillColor(sf::Color::Black);
+    timerText.setPosition(sf::Vector2f(width / 2 - 40.f, 10)); // center-ish
+
+    winnerText.setCharacterSize(48);
+    winnerText.setFillColor(sf::Color::Black);
+    winnerText.setPosition(sf::Vector2f(width / 2 - 150.f, height / 2 - 40.f));
+}
+
+void Hud::update(const World& world) {
+    const auto start = std::chrono::steady_clock::now();
+    char buf[32];
+
+    for (int p = 0; p < 2; ++p) {
+        int score = world.player(p).score;
+        if (score == shownScore[p]) continue;
+        shownScore[p] = score;
+        sf::Text& text = p == 0 ? player1ScoreText : player2ScoreText;
+        TRACE_SCOPE("hud score text");
+        text.setString(formatScore(buf, p == 0 ? "Player 1: " : "Player 2: ", score));
+        ++counters.rebuilds;
+    }
+
+    int remaining = world.remainingSeconds();
+    if (remaining != shownSeconds) {
+        shownSeconds = remaining;
+        TRACE_SCOPE("hud clock text");
+        timerText.setString(formatClock(buf, remaining));
+        ++counters.rebuilds;
+    }
+
+    // Decide winner (once, when the match ends)
+    if (world.isGameOver() != shownGameOver) {
+        shownGameOver = world.isGameOver();
+        if (shownGameOver) {
+            switch (world.winner()) {
+                case 1: winnerText.setString("Player 1 Wins!"); break;
+                case 2: winnerText.setString("Player 2 Wins!"); break;
+                default: winnerText.setString("Draw!"); break;
+            }
+            ++counters.rebuilds;
+        }
+    }
+
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    counters.lastNs = static_cast<std::uint64_t>(ns);
+    counters.totalNs += counters.lastNs;
+    ++counters.updates;
+}
+
+void Hud::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+    // Draw score display
+    target.draw(player1ScoreText, states);
+    target.draw(player2ScoreText, states);
+
+    // Draw timer
+    target.draw(timerText, states);
+
+    // If game over, show winner
+    if (shownGameOver) target.draw(winnerText, states);
+}
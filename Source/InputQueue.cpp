@@ -0,0 +1,105 @@
+// InputQueue.cpp
+#include "../include/InputQueue.hpp"
+
+namespace {
+PlayerInput toStep(MoveDir dir) {
+    PlayerInput in;
+    switch (dir) {
+        case MoveDir::Up:    in.dy = -1; break;
+        case MoveDir::Down:  in.dy = 1;  break;
+        case MoveDir::Left:  in.dx = -1; break;
+        case MoveDir::Right: in.dx = 1;  break;
+        default: break;
+    }
+    return in;
+}
+} // namespace
+
+void InputQueue::push(const InputEvent& ev) {
+    if (ev.player < 0 || ev.player > 1 || ev.dir == MoveDir::None) return;
+
+    if (eventCount == kEventCapacity) {
+        // Ring is full (no tick ran for a long time): fold the oldest event in now
+        apply(events[eventHead]);
+        eventHead = (eventHead + 1) % kEventCapacity;
+        --eventCount;
+    }
+    events[(eventHead + eventCount) % kEventCapacity] = ev;
+    ++eventCount;
+}
+
+void InputQueue::releaseAll() {
+    for (PlayerQueue& q : players) q.heldCount = 0;
+}
+
+void InputQueue::apply(const InputEvent& ev) {
+    PlayerQueue& q = players[ev.player];
+
+    // Drop any previous entry for this key from the held list
+    int kept = 0;
+    for (int i = 0; i < q.heldCount; ++i) {
+        if (q.held[i] != ev.dir) q.held[kept++] = q.held[i];
+    }
+    q.heldCount = kept;
+
+    if (!ev.pressed) return;
+
+    q.held[q.heldCount++] = ev.dir; // most recent press last
+
+    if (q.count == kMoveCapacity) {
+        ++stats.dropped;
+        return;
+    }
+    q.moves[(q.head + q.count) % kMoveCapacity] = { ev.dir, ev.timeUs };
+    ++q.count;
+}
+
+Inputs InputQueue::consume(const World& world, std::uint64_t nowUs) {
+    // Drain raw events in arrival order
+    while (eventCount > 0) {
+        apply(events[eventHead]);
+        eventHead = (eventHead + 1) % kEventCapacity;
+        --eventCount;
+    }
+
+    // Settle last tick's queued steps: taken, unless a conflict cancelled them
+    if (players[0].inFlight && players[1].inFlight && world.moveCancelled(0) && world.moveCancelled(1)) {
+        secondWaits = true;
+    }
+    for (int p = 0; p < 2; ++p) {
+        PlayerQueue& q = players[p];
+        if (!q.inFlight) continue;
+        q.inFlight = false;
+        if (world.moveCancelled(p)) continue; // stays at the head for a retry
+
+        const QueuedMove& m = q.moves[q.head];
+        q.head = (q.head + 1) % kMoveCapacity;
+        --q.count;
+
+        std::uint64_t lat = q.handedUs > m.timeUs ? q.handedUs - m.timeUs : 0;
+        ++stats.samples;
+        stats.totalUs += lat;
+        if (lat > stats.maxUs) stats.maxUs = lat;
+    }
+
+    Inputs inputs;
+    for (int p = 0; p < 2; ++p) {
+        PlayerQueue& q = players[p];
+        if (!world.readyToMove(p)) continue; // keep presses queued until the step can happen
+        if (p == 1 && secondWaits) {
+            const PlayerQueue& first = players[0];
+            if (first.count > 0 && !first.inFlight) continue; // player 0 has not retried yet
+            secondWaits = false;
+            if (first.inFlight) continue; // it retries alone this tick
+        }
+
+        if (q.count > 0) {
+            q.inFlight = true;
+            q.handedUs = nowUs;
+            inputs.player[p] = toStep(q.moves[q.head].dir);
+        } else if (q.heldCount > 0) {
+            inputs.player[p] = toStep(q.held[q.heldCount - 1]); // key held: keep walking
+        }
+    }
+    return inputs;
+}
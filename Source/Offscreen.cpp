@@ -0,0 +1,169 @@
+// Offscreen.cpp
+#include "../include/Offscreen.hpp"
+#include "../include/Trace.hpp"
+
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+
+#include "../include/CpuRasterizer.hpp"
+#include "../include/GameView.hpp"
+#include "../include/Rng.hpp"
+#include "../include/TextureAtlas.hpp"
+#include "../include/World.hpp"
+
+namespace {
+// Scripted match: each player random-walks from its own seeded stream
+Inputs scriptedInputs(Rng& rng) {
+    Inputs inputs;
+    for (PlayerInput& in : inputs.player) {
+        int r = static_cast<int>(rng.below(5));
+        in.dx = (r == 1) - (r == 2);
+        in.dy = (r == 3) - (r == 4);
+    }
+    return inputs;
+}
+
+std::string frameName(int frame) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "frame_%05d.png", frame);
+    return name;
+}
+
+std::string goldenPath(const std::string& dir, int frame) {
+    return dir + "/" + frameName(frame);
+}
+
+// Frame indices of the frame_NNNNN.png files in dir
+std::vector<int> framesIn(const std::string& dir) {
+    std::vector<int> frames;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(dir, ec)) {
+        const std::string name = entry.path().filename().string();
+        int frame = 0;
+        if (std::sscanf(name.c_str(), "frame_%d.png", &frame) == 1 && name == frameName(frame)) frames.push_back(frame);
+    }
+    return frames;
+}
+
+// Pixel-exact comparison of the rasterizer's frame with a reference PNG; says why on failure
+bool matchesGolden(const CpuRasterizer& cpu, const std::string& path) {
+    sf::Image golden;
+    if (!golden.loadFromFile(path)) {
+        std::cerr << "golden: cannot read " << path << "\n";
+        return false;
+    }
+    if (golden.getSize() != sf::Vector2u(cpu.width(), cpu.height())) {
+        std::cerr << "golden: " << path << " is " << golden.getSize().x << "x" << golden.getSize().y
+                  << ", rendered " << cpu.width() << "x" << cpu.height() << "\n";
+        return false;
+    }
+    const std::uint8_t* want = golden.getPixelsPtr();
+    const std::uint8_t* got = cpu.pixels();
+    const std::size_t bytes = static_cast<std::size_t>(cpu.width()) * cpu.height() * 4;
+    std::size_t differing = 0;
+    int maxDelta = 0;
+    for (std::size_t i = 0; i < bytes; i += 4) {
+        int delta = 0;
+        for (std::size_t c = 0; c < 4; ++c) delta = std::max(delta, std::abs(want[i + c] - got[i + c]));
+        if (delta == 0) continue;
+        ++differing;
+        maxDelta = std::max(maxDelta, delta);
+    }
+    if (differing == 0) return true;
+    std::cerr << "golden: " << path << ": " << differing << " pixels differ (max channel delta " << maxDelta << ")\n";
+    return false;
+}
+} // namespace
+
+int runOffscreen(const OffscreenOptions& options) {
+    WorldConfig config;
+    config.seed = options.seed;
+    World world(config);
+    Rng script(options.seed, 1); // stream 1: inputs never correlate with the spawner
+
+    TextureAtlas atlas;
+    if (!atlas.loadOrPack(options.assetDir)) return 1;
+
+    // --- Pick a backend: GPU render texture if a context can be created, else CPU ---
+    const bool compare = !options.goldenDir.empty();
+    bool tryGpu = !options.forceCpu && !compare; // goldens are CPU-rasterizer frames
+#if defined(__linux__)
+    // Without a display server SFML cannot create a GL context at all
+    if (!std::getenv("DISPLAY") && !std::getenv("WAYLAND_DISPLAY")) tryGpu = false;
+#endif
+    sf::Font font;
+    std::unique_ptr<sf::RenderTexture> target;
+    std::unique_ptr<GameView> view;
+    if (tryGpu && atlas.upload()) {
+        if (!font.openFromFile(options.assetDir + "/ARLRDBD.TTF")) {
+            std::cout << "Could not load " << options.assetDir << "/ARLRDBD.TTF, using default font\n";
+        }
+        view = std::make_unique<GameView>(atlas, font, world.width(), world.height());
+        target = std::make_unique<sf::RenderTexture>();
+        if (!target->resize(view->pixelSize())) {
+            target.reset();
+            view.reset();
+        }
+    }
+    std::unique_ptr<CpuRasterizer> cpu;
+    if (!target) cpu = std::make_unique<CpuRasterizer>(atlas, world.width(), world.height());
+    const char* backend = target ? "gpu-render-texture" : "cpu-raster";
+
+    std::vector<int> golden = options.goldenFrames;
+    if (compare && golden.empty()) golden = framesIn(options.goldenDir);
+    std::sort(golden.begin(), golden.end());
+    golden.erase(std::unique(golden.begin(), golden.end()), golden.end());
+    auto nextGolden = golden.begin();
+    int mismatches = 0;
+
+    PlayerState prev[2] = { world.player(0), world.player(1) };
+    const auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < options.ticks; ++frame) {
+        TRACE_SCOPE("offscreen frame");
+        prev[0] = world.player(0);
+        prev[1] = world.player(1);
+        world.step(scriptedInputs(script));
+
+        const bool dump = nextGolden != golden.end() && *nextGolden == frame;
+        if (target) {
+            view->update(world, prev, 1.f);
+            target->clear(sf::Color::Black);
+            target->draw(*view);
+            target->display();
+            if (dump && !target->getTexture().copyToImage().saveToFile(goldenPath(options.outDir, frame))) {
+                std::cerr << "Failed to write " << goldenPath(options.outDir, frame) << "\n";
+            }
+        } else {
+            cpu->render(world);
+            const bool mismatch = dump && compare && !matchesGolden(*cpu, goldenPath(options.goldenDir, frame));
+            if (mismatch) ++mismatches;
+            if ((mismatch || (dump && !compare)) && !cpu->savePng(goldenPath(options.outDir, frame))) {
+                std::cerr << "Failed to write " << goldenPath(options.outDir, frame) << "\n";
+            }
+        }
+        while (nextGolden != golden.end() && *nextGolden <= frame) ++nextGolden;
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("offscreen: backend=%s frames=%d seconds=%.3f fps=%.1f scores=%d:%d\n", backend, options.ticks,
+                seconds, seconds > 0 ? options.ticks / seconds : 0.0, world.player(0).score, world.player(1).score);
+    if (!compare) return 0;
+
+    for (; nextGolden != golden.end(); ++nextGolden) {
+        std::cerr << "golden: frame " << *nextGolden << " is past the last rendered frame\n";
+        ++mismatches;
+    }
+    if (golden.empty()) {
+        std::cerr << "golden: no frame_NNNNN.png in " << options.goldenDir << "\n";
+        return 1;
+    }
+    std::printf("golden: %d of %zu frames match %s\n", static_cast<int>(golden.size()) - mismatches, golden.size(),
+                options.goldenDir.c_str());
+    return mismatches ? 1 : 0;
+}
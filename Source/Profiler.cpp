@@ -0,0 +1,75 @@
+// Profiler.cpp
+#include "../include/Profiler.hpp"
+
+#include <algorithm>
+
+namespace {
+const char* const kPhaseNames[kPhaseCount] = {
+    "events", "input", "moves", "spawn", "hud", "board", "draw", "display", "frame"
+};
+} // namespace
+
+Profiler::Profiler()
+: history(static_cast<std::size_t>(kHistory * kPhaseCount), 0)
+, scratch(static_cast<std::size_t>(kHistory), 0)
+{
+    std::fill(current, current + kPhaseCount, 0);
+    frameStart = std::chrono::steady_clock::now();
+}
+
+Profiler::~Profiler() {
+    if (csv) std::fclose(csv);
+}
+
+const char* Profiler::name(Phase phase) {
+    return kPhaseNames[static_cast<int>(phase)];
+}
+
+bool Profiler::openCsv(const std::string& path) {
+    if (csv) std::fclose(csv);
+    csv = std::fopen(path.c_str(), "w");
+    if (!csv) return false;
+    std::fputs("frame", csv);
+    for (const char* n : kPhaseNames) std::fprintf(csv, ",%s_ns", n);
+    std::fputc('\n', csv);
+    return true;
+}
+
+void Profiler::beginFrame() {
+    std::fill(current, current + kPhaseCount, 0);
+    frameStart = std::chrono::steady_clock::now();
+}
+
+void Profiler::endFrame() {
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - frameStart).count();
+    current[static_cast<int>(Phase::Frame)] = static_cast<std::uint64_t>(ns);
+
+    std::uint64_t* row = &history[static_cast<std::size_t>((frameCount % kHistory) * kPhaseCount)];
+    std::copy(current, current + kPhaseCount, row);
+
+    if (csv) {
+        std::fprintf(csv, "%llu", static_cast<unsigned long long>(frameCount));
+        for (std::uint64_t v : current) std::fprintf(csv, ",%llu", static_cast<unsigned long long>(v));
+        std::fputc('\n', csv);
+    }
+    ++frameCount;
+}
+
+Profiler::Summary Profiler::summary(Phase phase) const {
+    Summary s;
+    const std::size_t n = static_cast<std::size_t>(std::min<std::uint64_t>(frameCount, kHistory));
+    if (n == 0) return s;
+
+    for (std::size_t i = 0; i < n; ++i) scratch[i] = history[i * kPhaseCount + static_cast<std::size_t>(phase)];
+    auto begin = scratch.begin();
+    auto end = begin + static_cast<std::ptrdiff_t>(n);
+
+    auto p50 = begin + static_cast<std::ptrdiff_t>(n / 2);
+    std::nth_element(begin, p50, end);
+    s.p50Us = static_cast<double>(*p50) / 1000.0;
+
+    auto p99 = begin + static_cast<std::ptrdiff_t>(std::min(n - 1, n * 99 / 100));
+    std::nth_element(begin, p99, end);
+    s.p99Us = static_cast<double>(*p99) / 1000.0;
+    return s;
+}
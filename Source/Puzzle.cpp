@@ -0,0 +1,208 @@
+// Puzzle.cpp
+#include "../include/Puzzle.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+bool isBoardChar(char c) {
+    switch (c) {
+        case '#': case '@': case '+': case '$': case '*': case '.': case ' ': case '-': case '_':
+            return true;
+        default:
+            return false;
+    }
+}
+
+// A board row has at least one wall and nothing but board characters
+bool isBoardLine(const std::string& line) {
+    if (line.find('#') == std::string::npos) return false;
+    return std::all_of(line.begin(), line.end(), isBoardChar);
+}
+
+std::string trimmed(const std::string& s) {
+    const std::size_t b = s.find_first_not_of(" \t");
+    if (b == std::string::npos) return std::string();
+    const std::size_t e = s.find_last_not_of(" \t");
+    return s.substr(b, e - b + 1);
+}
+
+PuzzleLevel buildLevel(const std::vector<std::string>& rows) {
+    PuzzleLevel level;
+    level.height = static_cast<int>(rows.size());
+    for (const std::string& row : rows) level.width = std::max(level.width, static_cast<int>(row.size()));
+    level.cells.assign(static_cast<std::size_t>(level.width * level.height), 0);
+
+    for (int y = 0; y < level.height; ++y) {
+        const std::string& row = rows[static_cast<std::size_t>(y)];
+        for (int x = 0; x < static_cast<int>(row.size()); ++x) {
+            const int cell = y * level.width + x;
+            std::uint8_t& flags = level.cells[static_cast<std::size_t>(cell)];
+            switch (row[static_cast<std::size_t>(x)]) {
+                case '#': flags = PuzzleLevel::kWall; break;
+                case '.': flags = PuzzleLevel::kGoal; break;
+                case '$': level.boxes.push_back(cell); break;
+                case '*': flags = PuzzleLevel::kGoal; level.boxes.push_back(cell); break;
+                case '@': level.player = cell; break;
+                case '+': flags = PuzzleLevel::kGoal; level.player = cell; break;
+                default: break;
+            }
+        }
+    }
+    return level;
+}
+
+} // namespace
+
+std::vector<PuzzleLevel> parseXsb(const std::string& text) {
+    std::vector<PuzzleLevel> levels;
+    std::vector<std::string> rows;
+    std::string pendingTitle;
+    int pendingPushes = -1;
+
+    auto finishLevel = [&]() {
+        if (rows.empty()) return;
+        levels.push_back(buildLevel(rows));
+        levels.back().title = pendingTitle.empty() ? "level " + std::to_string(levels.size()) : pendingTitle;
+        levels.back().expectedPushes = pendingPushes;
+        pendingTitle.clear();
+        pendingPushes = -1;
+        rows.clear();
+    };
+
+    std::istringstream in(text);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (isBoardLine(line)) {
+            rows.push_back(line);
+            continue;
+        }
+
+        // Titles before a board name it; a title right after a board names that board
+        const bool afterBoard = !rows.empty();
+        finishLevel();
+        std::string t = trimmed(line);
+        if (t.rfind("Title:", 0) == 0) {
+            t = trimmed(t.substr(6));
+            if (afterBoard) levels.back().title = t;
+            else pendingTitle = t;
+        } else if (t.rfind("Pushes:", 0) == 0) {
+            const int pushes = std::atoi(t.c_str() + 7);
+            if (afterBoard) levels.back().expectedPushes = pushes;
+            else pendingPushes = pushes;
+        } else if (!t.empty() && t[0] == ';') {
+            t = trimmed(t.substr(1));
+            if (afterBoard) levels.back().title = t;
+            else pendingTitle = t;
+        }
+    }
+    finishLevel();
+    return levels;
+}
+
+std::vector<PuzzleLevel> loadXsbFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return {};
+    std::ostringstream text;
+    text << file.rdbuf();
+    return parseXsb(text.str());
+}
+
+PuzzleLevel puzzleFromWorld(const World& world, int playerIndex) {
+    PuzzleLevel level;
+    level.title = "world";
+    level.width = world.width();
+    level.height = world.height();
+    level.rules = PuzzleRules::Portal;
+    level.cells.assign(static_cast<std::size_t>(level.width * level.height), 0);
+
+    for (int y = 0; y < level.height; ++y) {
+        for (int x = 0; x < level.width; ++x) {
+            const int cell = y * level.width + x;
+            switch (world.tileAt(x, y)) {
+                case TileType::Box: level.cells[static_cast<std::size_t>(cell)] = PuzzleLevel::kWall; break;
+                case TileType::Portal: level.cells[static_cast<std::size_t>(cell)] = PuzzleLevel::kGoal; break;
+                case TileType::PushableBox: level.boxes.push_back(cell); break;
+                default: break;
+            }
+        }
+    }
+    const PlayerState& p = world.player(playerIndex);
+    level.player = p.y * level.width + p.x;
+    return level;
+}
+
+std::string toXsb(const PuzzleLevel& level) {
+    std::string out;
+    out.reserve(static_cast<std::size_t>((level.width + 1) * level.height));
+    std::vector<char> hasBox(level.cells.size(), 0);
+    for (int b : level.boxes) hasBox[static_cast<std::size_t>(b)] = 1;
+
+    for (int y = 0; y < level.height; ++y) {
+        for (int x = 0; x < level.width; ++x) {
+            const int cell = y * level.width + x;
+            const bool goal = level.isGoal(cell);
+            char c = ' ';
+            if (level.isWall(cell)) c = '#';
+            else if (hasBox[static_cast<std::size_t>(cell)]) c = goal ? '*' : '$';
+            else if (cell == level.player) c = goal ? '+' : '@';
+            else if (goal) c = '.';
+            out += c;
+        }
+        while (!out.empty() && out.back() == ' ') out.pop_back();
+        out += '\n';
+    }
+    return out;
+}
+
+bool checkSolution(const PuzzleLevel& level, const std::string& lurd) {
+    if (level.player < 0) return false;
+    std::vector<char> hasBox(level.cells.size(), 0);
+    for (int b : level.boxes) hasBox[static_cast<std::size_t>(b)] = 1;
+
+    auto blocked = [&](int x, int y) {
+        return x < 0 || y < 0 || x >= level.width || y >= level.height || level.isWall(y * level.width + x);
+    };
+
+    int px = level.player % level.width;
+    int py = level.player / level.width;
+    for (char c : lurd) {
+        int dx = 0;
+        int dy = 0;
+        switch (c | 0x20) { // lowercase
+            case 'u': dy = -1; break;
+            case 'd': dy = 1; break;
+            case 'l': dx = -1; break;
+            case 'r': dx = 1; break;
+            default: return false;
+        }
+        const int nx = px + dx;
+        const int ny = py + dy;
+        if (blocked(nx, ny)) return false;
+        const std::size_t next = static_cast<std::size_t>(ny * level.width + nx);
+        const bool push = (c & 0x20) == 0;
+        if (push != (hasBox[next] != 0)) return false; // case must match what is ahead
+
+        if (push) {
+            const int bx = nx + dx;
+            const int by = ny + dy;
+            if (blocked(bx, by)) return false;
+            const std::size_t boxCell = static_cast<std::size_t>(by * level.width + bx);
+            if (hasBox[boxCell]) return false;
+            hasBox[next] = 0;
+            const bool consumed = level.rules == PuzzleRules::Portal && level.isGoal(static_cast<int>(boxCell));
+            if (!consumed) hasBox[boxCell] = 1;
+        }
+        px = nx;
+        py = ny;
+    }
+
+    for (std::size_t c = 0; c < hasBox.size(); ++c) {
+        if (hasBox[c] && !level.isGoal(static_cast<int>(c))) return false;
+    }
+    return true;
+}
@@ -1,493 +1,343 @@
 // Sokoban.cpp
 #include <SFML/Graphics.hpp>
+#include <algorithm>
 #include <array>
 #include <optional>
 #include <iostream>
 #include <memory>
 #include <string>
-
-// --- GameObject: encapsulated, drawable wrapper for either a rectangle or a textured sprite ---
-class GameObject : public sf::Drawable {
-public:
-    GameObject() : isPenetrate(false) {}
-
-    virtual ~GameObject() = default;
-
-    // Keep signatures compatible with your usage (sf::Vector2<float> alias)
-    virtual void setSize(const sf::Vector2f& size) {
-        shape.setSize(size);
-    }
-
-    virtual void setPosition(const sf::Vector2f& pos) {
-        shape.setPosition(pos);
-        if (sprite) sprite->setPosition(pos);
-    }
-
-    virtual void setFillColor(const sf::Color& color) {
-        shape.setFillColor(color);
-    }
-
-    // true => cannot be walked through
-    bool isPenetrate;
-
-    // By default not pushable
-    virtual bool isPushable() const { return false; }
-    
-    // Check if this is a portal
-    virtual bool isPortal() const { return false; }
-
-protected:
-    sf::RectangleShape shape;
-    std::optional<sf::Sprite> sprite; // sf::Sprite requires a texture at construction
-
-    // draw either sprite (when textured) or the rectangle shape
-    virtual void draw(sf::RenderTarget& target, sf::RenderStates states) const override {
-        if (sprite) target.draw(*sprite, states);
-        else target.draw(shape, states);
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <cstdlib>
+#include <ctime>
+
+#include "../include/AllocStats.hpp"
+#include "../include/GameView.hpp"
+#include "../include/InputQueue.hpp"
+#include "../include/Offscreen.hpp"
+#include "../include/Profiler.hpp"
+#include "../include/TextureAtlas.hpp"
+#include "../include/Trace.hpp"
+#include "../include/World.hpp"
+
+// --- Key bindings: P1 = WASD, P2 = arrow keys (scancodes, layout independent) ---
+static bool mapKey(sf::Keyboard::Scancode code, int& player, MoveDir& dir) {
+    switch (code) {
+        case sf::Keyboard::Scan::W:     player = 0; dir = MoveDir::Up;    return true;
+        case sf::Keyboard::Scan::S:     player = 0; dir = MoveDir::Down;  return true;
+        case sf::Keyboard::Scan::A:     player = 0; dir = MoveDir::Left;  return true;
+        case sf::Keyboard::Scan::D:     player = 0; dir = MoveDir::Right; return true;
+        case sf::Keyboard::Scan::Up:    player = 1; dir = MoveDir::Up;    return true;
+        case sf::Keyboard::Scan::Down:  player = 1; dir = MoveDir::Down;  return true;
+        case sf::Keyboard::Scan::Left:  player = 1; dir = MoveDir::Left;  return true;
+        case sf::Keyboard::Scan::Right: player = 1; dir = MoveDir::Right; return true;
+        default: return false;
     }
-};
-
-// --- Box: a blocking tile with an optional texture (immovable) ---
-class Box : public GameObject {
-public:
-    // tex pointer must outlive this Box (we keep textures in main)
-    Box(const sf::Texture* tex = nullptr, float desiredSize = 0.f) {
-        isPenetrate = true; // immovable blocking tile
-
-        if (tex) {
-            sprite.emplace(*tex);
-            if (desiredSize > 0.f) {
-                auto tsz = tex->getSize();
-                if (tsz.x > 0 && tsz.y > 0) {
-                    sprite->setScale(sf::Vector2f(desiredSize / static_cast<float>(tsz.x),
-                                                  desiredSize / static_cast<float>(tsz.y)));
-                }
-                shape.setSize(sf::Vector2f(desiredSize, desiredSize));
-            }
+}
+
+// --- Soak mode: run matches headless with random inputs and report heap traffic ---
+// The steady-state tick (moves, pushes, portal scoring, spawning, match restarts)
+// must not touch the heap; any allocation counted here is a regression.
+static int runSoak(long ticks) {
+    World world;
+    Rng inputRng(0x50A4);
+    Inputs inputs;
+    long matches = 1;
+
+    const allocstats::Snapshot before = allocstats::current();
+    for (long i = 0; i < ticks; ++i) {
+        for (PlayerInput& in : inputs.player) {
+            int r = static_cast<int>(inputRng.below(5));
+            in.dx = (r == 1) - (r == 2);
+            in.dy = (r == 3) - (r == 4);
+        }
+        world.step(inputs);
+        if (world.isGameOver()) {
+            world.reset();
+            ++matches;
         }
     }
-
-    void setSize(const sf::Vector2f& size) override {
-        shape.setSize(size);
-    }
-};
-
-// --- PushableBox: a box that players can push one tile at a time ---
-class PushableBox : public GameObject {
-public:
-    PushableBox(const sf::Texture* tex = nullptr, float desiredSize = 0.f) {
-        isPenetrate = true; // blocks walking unless pushed
-        if (tex) {
-            sprite.emplace(*tex);
-            if (desiredSize > 0.f) {
-                auto tsz = tex->getSize();
-                if (tsz.x > 0 && tsz.y > 0) {
-                    sprite->setScale(sf::Vector2f(desiredSize / static_cast<float>(tsz.x),
-                                                  desiredSize / static_cast<float>(tsz.y)));
-                }
-                shape.setSize(sf::Vector2f(desiredSize, desiredSize));
+    const allocstats::Snapshot delta = allocstats::since(before);
+
+    // The final state hash fingerprints the whole seeded run: builds that
+    // disagree on it (compiler, LTO, PGO) have diverged somewhere
+    std::cout << "soak: " << ticks << " ticks, " << matches << " matches, "
+              << delta.allocations << " allocations, " << delta.frees << " frees, "
+              << delta.bytes << " bytes, state " << std::hex << world.stateHash() << std::dec << "\n";
+    return delta.allocations == 0 ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+
+    // --- Command line ---
+    //   --soak [ticks]      run headless and exit (default 1000000 ticks)
+    //   --tick-rate <hz>    simulation rate (default 60)
+    //   --fps <n>           cap the render rate (0 = uncapped); default is vsync
+    //   --pack-atlas        decode Assets/*.jpg once, write Assets/atlas.png + atlas.txt, exit
+    //   --profile-csv <f>   append one row of phase timings per frame to <f>
+    //   --trace <f>         record trace events, written to <f> (Chrome trace JSON) on exit and on F4
+    //   --offscreen <n>     render a scripted n-tick match offscreen, print FPS, exit
+    //     --cpu-raster      force the software rasterizer
+    //     --frames <a,b,..> frame indices to save as frame_NNNNN.png
+    //     --golden <dir>    compare the frames (default: every <dir>/frame_NNNNN.png)
+    //                       with <dir> instead of saving them; exit 1 on a mismatch
+    //     --out-dir <dir>   where frames go, and the actual frame of a mismatch (default .)
+    //     --asset-dir <dir> atlas source (default Assets)
+    //     --seed <n>        match seed (default 1)
+    // In game: F3 toggles the frame-time overlay (p50/p99 per phase), F4 writes the trace so far
+    int tickRate = 60;
+    int fpsLimit = -1; // -1 => vsync
+    const char* profileCsv = nullptr;
+    const char* tracePath = nullptr;
+    long soakTicks = -1;
+    bool packAtlas = false;
+    bool offscreen = false;
+    OffscreenOptions offscreenOptions;
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--soak") == 0) {
+            soakTicks = 1000000;
+            if (hasValue && argv[i + 1][0] != '-') soakTicks = std::atol(argv[++i]);
+        } else if (std::strcmp(argv[i], "--pack-atlas") == 0) {
+            packAtlas = true;
+        } else if (std::strcmp(argv[i], "--tick-rate") == 0 && hasValue) {
+            tickRate = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--fps") == 0 && hasValue) {
+            fpsLimit = std::max(0, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--profile-csv") == 0 && hasValue) {
+            profileCsv = argv[++i];
+        } else if (std::strcmp(argv[i], "--trace") == 0 && hasValue) {
+            tracePath = argv[++i];
+        } else if (std::strcmp(argv[i], "--offscreen") == 0) {
+            offscreen = true;
+            if (hasValue && argv[i + 1][0] != '-') offscreenOptions.ticks = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--cpu-raster") == 0) {
+            offscreenOptions.forceCpu = true;
+        } else if (std::strcmp(argv[i], "--frames") == 0 && hasValue) {
+            for (const char* p = argv[++i]; *p; ) {
+                offscreenOptions.goldenFrames.push_back(std::atoi(p));
+                while (*p && *p != ',') ++p;
+                if (*p == ',') ++p;
             }
+        } else if (std::strcmp(argv[i], "--golden") == 0 && hasValue) {
+            offscreenOptions.goldenDir = argv[++i];
+        } else if (std::strcmp(argv[i], "--out-dir") == 0 && hasValue) {
+            offscreenOptions.outDir = argv[++i];
+        } else if (std::strcmp(argv[i], "--asset-dir") == 0 && hasValue) {
+            offscreenOptions.assetDir = argv[++i];
+        } else if (std::strcmp(argv[i], "--seed") == 0 && hasValue) {
+            offscreenOptions.seed = std::strtoull(argv[++i], nullptr, 10);
         }
     }
 
-    bool isPushable() const override { return true; }
+    if (tracePath) {
+        trace::setThreadName("main");
+        trace::start();
+    }
+    auto writeTrace = [&]() {
+        if (!tracePath) return;
+        if (trace::flush(tracePath)) std::cout << "trace written to " << tracePath << "\n";
+        else std::cerr << "Failed to write " << tracePath << "\n";
+    };
 
-    void setSize(const sf::Vector2f& size) override {
-        shape.setSize(size);
+    if (soakTicks >= 0) {
+        const int rc = runSoak(soakTicks);
+        writeTrace();
+        return rc;
     }
-};
-
-// --- Portal: special floor tile that 'consumes' a pushable box and awards points ---
-class Portal : public GameObject {
-public:
-    Portal(const sf::Texture* tex = nullptr, float desiredSize = 0.f) {
-        isPenetrate = false; // walkable like floor
-        if (tex) {
-            sprite.emplace(*tex);
-            if (desiredSize > 0.f) {
-                auto tsz = tex->getSize();
-                if (tsz.x > 0 && tsz.y > 0) {
-                    sprite->setScale(sf::Vector2f(desiredSize / static_cast<float>(tsz.x),
-                                                  desiredSize / static_cast<float>(tsz.y)));
-                }
-                shape.setSize(sf::Vector2f(desiredSize, desiredSize));
-            }
-        } else {
-            // fallback: pink block if texture not provided
-            shape.setSize(sf::Vector2f(desiredSize, desiredSize));
-            shape.setFillColor(sf::Color(255, 105, 180)); // hot pink fallback
+    if (offscreen) {
+        const int rc = runOffscreen(offscreenOptions);
+        writeTrace();
+        return rc;
+    }
+    if (packAtlas) {
+        TextureAtlas packer;
+        if (!packer.pack("Assets")) return 1;
+        const std::string imagePath = std::string("Assets/") + kPackedAtlasImage;
+        const std::string tablePath = std::string("Assets/") + kPackedAtlasTable;
+        if (!packer.savePacked(imagePath, tablePath)) {
+            std::cerr << "Failed to write " << imagePath << "\n";
+            return 1;
         }
+        std::cout << "wrote " << imagePath << " and " << tablePath << "\n";
+        return 0;
     }
 
-    bool isPortal() const override { return true; }
-};
-
+    // --- Simulation (all game rules live in World; this file only draws it) ---
+    WorldConfig worldConfig = WorldConfig::forTickRate(tickRate);
+    worldConfig.seed = static_cast<std::uint64_t>(std::time(nullptr)); // a new match layout every launch
+    World world(worldConfig);
 
-int main() {
+    // --- Profiler: scoped timers per loop phase, overlay on F3, optional CSV ---
+    Profiler profiler;
+    world.setProfiler(&profiler);
+    if (profileCsv && !profiler.openCsv(profileCsv)) {
+        std::cerr << "Could not open " << profileCsv << " for writing\n";
+    }
 
     // --- Map constants ---
-    constexpr int MAP_W = 16 * 2;
-    constexpr int MAP_H = 9 * 2;
-    constexpr float TILE = 37.f; // tile size in pixels
+    const int MAP_W = world.width();
+    const int MAP_H = world.height();
+    constexpr float TILE = kTileSize; // tile size in pixels
     const unsigned winW = static_cast<unsigned>(MAP_W * TILE);
     const unsigned winH = static_cast<unsigned>(MAP_H * TILE);
 
     sf::RenderWindow window(sf::VideoMode({winW, winH}), "Sokuban dual!");
-    window.setFramerateLimit(10);
-    window.setKeyRepeatEnabled(false); // disable OS key repeat so event repeats don't interfere (still using polling below)
+    // Rendering is decoupled from the simulation rate (see the fixed-step loop below)
+    if (fpsLimit < 0) window.setVerticalSyncEnabled(true);
+    else window.setFramerateLimit(static_cast<unsigned>(fpsLimit));
+    window.setKeyRepeatEnabled(false); // held keys are repeated by the InputQueue at the sim's move rate
 
-    // --- Player scores ---
-    int player1Score = 0;
-    int player2Score = 0;
-    
     // --- Font for score display ---
     sf::Font font;
     // Try to load a font - if it fails, we'll use default rendering
-    if (!font.openFromFile("Assets/ARLRDBD.ttf")) {
+    if (!font.openFromFile("Assets/ARLRDBD.TTF")) {
         // If custom font fails, we'll still display scores but with default font
-        std::cout << "Could not load Assets/ARLRDBD.ttf, using default font\n";
-    }
-    
-    // Score text objects
-    sf::Text player1ScoreText(font);
-    sf::Text player2ScoreText(font);
-    
-    player1ScoreText.setFont(font);
-    player1ScoreText.setCharacterSize(24);
-    player1ScoreText.setFillColor(sf::Color::Red);
-    player1ScoreText.setPosition(sf::Vector2f(10,10));
-    
-    player2ScoreText.setFont(font);
-    player2ScoreText.setCharacterSize(24);
-    player2ScoreText.setFillColor(sf::Color::Blue);
-    player2ScoreText.setPosition(sf::Vector2f(MAP_W * TILE - TILE * 4,10));
-
-    // --- Timer setup ---
-    sf::Clock gameClock;                   // to measure elapsed time
-    const int GAME_DURATION = 60;          // 1 min in seconds
-    sf::Text timerText(font);
-    timerText.setFont(font);
-    timerText.setCharacterSize(24);
-    timerText.setFillColor(sf::Color::Black);
-    timerText.setPosition(sf::Vector2f(MAP_W * TILE / 2 - 40.f, 10)); // center-ish
-
-    bool gameOver = false;   // track if timer has ended
-    sf::Text winnerText(font);
-    winnerText.setFont(font);
-    winnerText.setCharacterSize(48);
-    winnerText.setFillColor(sf::Color::Black);
-    winnerText.setPosition(sf::Vector2f(MAP_W * TILE / 2 - 150.f, MAP_H * TILE / 2 - 40.f));
-
-    // --- Box spawner setup ---
-    sf::Clock boxSpawnClock;
-
-    // --- Load textures (kept alive in main) ---
-    // immovable special box texture
-    sf::Texture specialBoxTex;
-    if (!specialBoxTex.loadFromFile("Assets/SpecialBox.jpg")) {
-        std::cerr << "Failed to load Assets/SpecialBox.jpg\n";
-        return 1;
-    }
-
-    // pushable box texture (user requested box.jpg in Assets/)
-    sf::Texture pushableBoxTex;
-    if (!pushableBoxTex.loadFromFile("Assets/box.jpg")) {
-        std::cerr << "Failed to load Assets/box.jpg\n";
-        return 1;
+        std::cout << "Could not load Assets/ARLRDBD.TTF, using default font\n";
     }
 
-    // player textures
-    sf::Texture player1Tex;
-    if (!player1Tex.loadFromFile("Assets/Player1.jpg")) {
-        std::cerr << "Failed to load Assets/Player1.jpg\n";
-        return 1;
+    // Profiler overlay (refreshed a few times per second while visible)
+    sf::Text profileText(font);
+    profileText.setCharacterSize(14);
+    profileText.setFillColor(sf::Color(20, 20, 20));
+    profileText.setOutlineColor(sf::Color(255, 255, 255, 200));
+    profileText.setOutlineThickness(1.f);
+    profileText.setPosition(sf::Vector2f(10.f, 44.f));
+    bool showProfile = false;
+    std::uint64_t profileRefreshFrame = 0;
+
+    // --- Textures: every tile and player image lives in one atlas texture ---
+    TextureAtlas atlas;
+    if (!atlas.loadOrPack("Assets")) {
+        return 1; // a required image is missing (already reported)
     }
-    sf::Texture player2Tex;
-    if (!player2Tex.loadFromFile("Assets/Player2.jpg")) {
-        std::cerr << "Failed to load Assets/Player2.jpg\n";
+    if (!atlas.upload()) {
+        std::cerr << "Failed to create the atlas texture\n";
         return 1;
     }
 
-    // portal texture
-    sf::Texture portalTex;
-    if (!portalTex.loadFromFile("Assets/portal.jpg")) {
-        std::cerr << "Failed to load Assets/portal.jpg, using pink fallback\n";
-    }
+    // --- View: board, players and HUD (text rebuilt only on change) ---
+    GameView view(atlas, font, MAP_W, MAP_H, TILE);
 
-    // --- Random number generator ---
-    std::srand(static_cast<unsigned>(std::time(nullptr)));
+    // --- Fixed-timestep loop state ---
+    // The simulation advances in fixed ticks fed by an accumulator; rendering runs
+    // at its own rate and interpolates player positions between the last two ticks.
+    const float tickDt = 1.f / static_cast<float>(world.getConfig().tickRate);
+    const float maxFrameDt = 0.25f; // avoid a spiral of death after a long stall
+    sf::Clock frameClock;
+    float accumulator = 0.f;
+    PlayerState prev[2] = { world.player(0), world.player(1) };
 
-    // --- Allocate raw 2D array for tiles (pointers to GameObject so we can store different derived objects) ---
-    GameObject*** tiles = new GameObject**[MAP_H];
-    for (int y = 0; y < MAP_H; ++y) {
-        tiles[y] = new GameObject*[MAP_W];
-    }
-
-    // Helper: set floor tile properties (size, position, color)
-    auto makeFloorAt = [&](int x, int y) -> GameObject* {
-        GameObject* g = new GameObject();
-        g->setSize(sf::Vector2f(TILE - 1.f, TILE - 1.f));
-        g->setPosition(sf::Vector2f(x * TILE, y * TILE));
-        bool dark = ((x + y) % 2) == 0;
-        g->setFillColor(dark ? sf::Color(220, 226, 234) : sf::Color(240, 244, 248));
-        g->isPenetrate = false; // walkable
-        return g;
-    };
-
-    // --- Initialize map (checkerboard) with plain GameObject floor instances ---
-    for (int y = 0; y < MAP_H; ++y) {
-        for (int x = 0; x < MAP_W; ++x) {
-            tiles[y][x] = makeFloorAt(x, y);
-        }
-    }
-
-    // --- Place an immovable special box at center (example) ---
-    const int centerX = MAP_W / 2;
-    const int centerY = MAP_H / 2;
-    delete tiles[centerY][centerX];
-    tiles[centerY][centerX] = new Box(&specialBoxTex, TILE - 4.f);
-    tiles[centerY][centerX]->setPosition(sf::Vector2f(centerX * TILE, centerY * TILE));
-
-    // --- Place a couple of pushable boxes (player can push these) ---
-    const int pb1X = centerX + 1;
-    const int pb1Y = centerY;
-    delete tiles[pb1Y][pb1X];
-    tiles[pb1Y][pb1X] = new PushableBox(&pushableBoxTex, TILE - 4.f);
-    tiles[pb1Y][pb1X]->setPosition(sf::Vector2f(pb1X * TILE, pb1Y * TILE));
-
-    const int pb2X = centerX - 2;
-    const int pb2Y = centerY;
-    delete tiles[pb2Y][pb2X];
-    tiles[pb2Y][pb2X] = new PushableBox(&pushableBoxTex, TILE - 4.f);
-    tiles[pb2Y][pb2X]->setPosition(sf::Vector2f(pb2X * TILE, pb2Y * TILE));
-
-    // --- Place a portal for testing ---
-    const int portalX = centerX + 3;
-    const int portalY = centerY + 2;
-    delete tiles[portalY][portalX];
-    tiles[portalY][portalX] = new Portal(portalTex.getSize().x > 0 ? &portalTex : nullptr, TILE - 1.f);
-    tiles[portalY][portalX]->setPosition(sf::Vector2f(portalX * TILE, portalY * TILE));
-
-
-    // --- Player 1 setup (sprite from Assets/Player1.jpg, WASD) ---
-    sf::Sprite player1(player1Tex);
-    float desiredSize = TILE - 4.f;
-    auto t1sz = player1Tex.getSize();
-    if (t1sz.x > 0 && t1sz.y > 0) {
-        player1.setScale(sf::Vector2f(desiredSize / static_cast<float>(t1sz.x),
-                                     desiredSize / static_cast<float>(t1sz.y)));
-    }
-
-    int p1X = MAP_W / 4;
-    int p1Y = MAP_H / 2;
-    player1.setPosition(sf::Vector2f(p1X * TILE + 2.f, p1Y * TILE + 2.f));
-
-    // --- Player 2 setup (sprite from Assets/Player2.jpg, Arrow keys) ---
-    sf::Sprite player2(player2Tex);
-    auto t2sz = player2Tex.getSize();
-    if (t2sz.x > 0 && t2sz.y > 0) {
-        player2.setScale(sf::Vector2f(desiredSize / static_cast<float>(t2sz.x),
-                                     desiredSize / static_cast<float>(t2sz.y)));
-    }
-
-    int p2X = (MAP_W * 3) / 4;
-    int p2Y = MAP_H / 2;
-    player2.setPosition(sf::Vector2f(p2X * TILE + 2.f, p2Y * TILE + 2.f));
+    // --- Input: key events are queued with timestamps and consumed by the sim tick ---
+    InputQueue inputQueue;
+    sf::Clock inputClock;
+    auto nowUs = [&]() { return static_cast<std::uint64_t>(inputClock.getElapsedTime().asMicroseconds()); };
 
     // --- Game loop ---
     while (window.isOpen()) {
-        // ---------- Timer update ----------
-        if (!gameOver) {
-            int elapsed = static_cast<int>(gameClock.getElapsedTime().asSeconds());
-            int remaining = GAME_DURATION - elapsed;
-            if (remaining < 0) remaining = 0;
-        
-            int minutes = remaining / 60;
-            int seconds = remaining % 60;
-            timerText.setString(
-                (seconds < 10 ? "0" : "") + std::to_string(minutes) + ":" + (seconds < 10 ? "0" : "") + std::to_string(seconds)
-            );
-        
-            if (remaining <= 0) {
-                gameOver = true;
-            
-                // Decide winner
-                if (player1Score > player2Score) {
-                    winnerText.setString("Player 1 Wins!");
-                } else if (player2Score > player1Score) {
-                    winnerText.setString("Player 2 Wins!");
-                } else {
-                    winnerText.setString("Draw!");
+        profiler.beginFrame();
+        TRACE_SCOPE("frame");
+
+        // Event loop: window events plus key presses/releases for the input queue
+        {
+            ScopedTimer timer(&profiler, Phase::Events);
+            TRACE_SCOPE("events");
+            while (auto ev = window.pollEvent()) {
+                if (ev->is<sf::Event::Closed>()) {
+                    window.close();
+                } else if (ev->is<sf::Event::FocusLost>()) {
+                    inputQueue.releaseAll(); // we won't see the key-up events
+                } else if (const auto* key = ev->getIf<sf::Event::KeyPressed>()) {
+                    if (key->scancode == sf::Keyboard::Scan::F3) {
+                        showProfile = !showProfile;
+                        profileRefreshFrame = profiler.frames();
+                        continue;
+                    }
+                    if (key->scancode == sf::Keyboard::Scan::F4) {
+                        writeTrace();
+                        continue;
+                    }
+                    InputEvent ie;
+                    if (mapKey(key->scancode, ie.player, ie.dir)) {
+                        ie.pressed = true;
+                        ie.timeUs = nowUs();
+                        inputQueue.push(ie);
+                    }
+                } else if (const auto* key = ev->getIf<sf::Event::KeyReleased>()) {
+                    InputEvent ie;
+                    if (mapKey(key->scancode, ie.player, ie.dir)) {
+                        ie.pressed = false;
+                        ie.timeUs = nowUs();
+                        inputQueue.push(ie);
+                    }
                 }
             }
         }
 
-        // ---------- Automatic Box Spawning ----------
-        if (!gameOver && boxSpawnClock.getElapsedTime().asSeconds() >= 2.f) {
-            boxSpawnClock.restart();
-        
-            // Try to place a box in a random empty tile
-            int randX = std::rand() % MAP_W;
-            int randY = std::rand() % MAP_H;
-        
-            GameObject* target = tiles[randY][randX];
-        
-            // Only replace if tile is a floor (not a box, portal, or wall)
-            if (!target->isPushable() && !target->isPortal()) {
-                // Delete current floor
-                delete tiles[randY][randX];
-            
-                // Place new pushable box
-                tiles[randY][randX] = new PushableBox(&pushableBoxTex, TILE - 4.f);
-                tiles[randY][randX]->setPosition(sf::Vector2f(randX * TILE, randY * TILE));
+        accumulator += std::min(frameClock.restart().asSeconds(), maxFrameDt);
+        int ticksThisFrame = 0;
+        while (accumulator >= tickDt) {
+            ++ticksThisFrame;
+            accumulator -= tickDt;
+
+            // ---------- Input for this tick ----------
+            Inputs inputs;
+            {
+                ScopedTimer timer(&profiler, Phase::Input);
+                inputs = inputQueue.consume(world, nowUs());
             }
-        }
-
 
-        // Event loop: only use events for window/system events now
-        while (auto ev = window.pollEvent()) {
-            if (ev->is<sf::Event::Closed>()) {
-                window.close();
-            }
-            // remove per-key movement handling from here
+            // ---------- Simulation ----------
+            prev[0] = world.player(0);
+            prev[1] = world.player(1);
+            world.step(inputs);
         }
 
-        // ---------- Realtime (polled) input handling ----------
-        // compute each player's desired direction (dx,dy) based on keys held this frame
-        int p1_dx = 0, p1_dy = 0;
-        int p2_dx = 0, p2_dy = 0;
-
-        // Player 1 (WASD) - using scancodes to match your event usage
-        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Scan::W)) p1_dy = -1;
-        else if (sf::Keyboard::isKeyPressed(sf::Keyboard::Scan::S)) p1_dy = 1;
-        else if (sf::Keyboard::isKeyPressed(sf::Keyboard::Scan::A)) p1_dx = -1;
-        else if (sf::Keyboard::isKeyPressed(sf::Keyboard::Scan::D)) p1_dx = 1;
-
-        // Player 2 (Arrow keys)
-        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Scan::Up))    p2_dy = -1;
-        else if (sf::Keyboard::isKeyPressed(sf::Keyboard::Scan::Down))  p2_dy = 1;
-        else if (sf::Keyboard::isKeyPressed(sf::Keyboard::Scan::Left))  p2_dx = -1;
-        else if (sf::Keyboard::isKeyPressed(sf::Keyboard::Scan::Right)) p2_dx = 1;
-
-        // helper used already in your code (keeps push logic centralized)
-        auto try_move_player = [&](int &px, int &py, int dx, int dy, int otherX, int otherY, int playerNum) {
-            if (dx == 0 && dy == 0) return; // no movement intended
-            int newX = px + dx;
-            int newY = py + dy;
-
-            // prevent moving onto the other player's *current* position
-            if (newX == otherX && newY == otherY) return;
-
-            // bounds check
-            if (newX < 0 || newX >= MAP_W || newY < 0 || newY >= MAP_H) return;
-
-            GameObject* target = tiles[newY][newX];
-
-            if (!target->isPenetrate) {
-                px = newX;
-                py = newY;
-                return;
-            }
+        TRACE_COUNTER("ticks per frame", ticksThisFrame);
 
-            PushableBox* pb = dynamic_cast<PushableBox*>(target);
-            if (pb) {
-                int boxNewX = newX + dx;
-                int boxNewY = newY + dy;
-                if (boxNewX < 0 || boxNewX >= MAP_W || boxNewY < 0 || boxNewY >= MAP_H) return;
-                if ((boxNewX == otherX && boxNewY == otherY) || (boxNewX == px && boxNewY == py)) return;
-                GameObject* boxTarget = tiles[boxNewY][boxNewX];
-                
-                // Check if box is being pushed into a portal
-                if (boxTarget->isPortal()) {
-                    // Box disappears into portal, player gets points
-                    delete tiles[newY][newX]; // Delete the pushable box
-                    tiles[newY][newX] = makeFloorAt(newX, newY); // Replace with floor
-                    
-                    // Award points to the player who pushed it
-                    if (playerNum == 1) {
-                        player1Score += 10;
-                    } else {
-                        player2Score += 10;
-                    }
-                    
-                    px = newX; // Player moves to where box was
-                    py = newY;
-                    return;
-                }
-                
-                if (!boxTarget->isPenetrate) {
-                    delete boxTarget;
-                    tiles[boxNewY][boxNewX] = tiles[newY][newX];
-                    tiles[boxNewY][boxNewX]->setPosition(sf::Vector2f(boxNewX * TILE, boxNewY * TILE));
-                    tiles[newY][newX] = makeFloorAt(newX, newY);
-                    px = newX;
-                    py = newY;
-                } else {
-                    return;
-                }
-            } else {
-                return;
+        // Board quads, HUD text and interpolated player sprites
+        view.update(world, prev, accumulator / tickDt, &profiler);
+
+        if (showProfile && profiler.frames() >= profileRefreshFrame) {
+            profileRefreshFrame = profiler.frames() + 15;
+            char buf[512];
+            int n = std::snprintf(buf, sizeof(buf), "%-8s %8s %8s\n", "phase", "p50 us", "p99 us");
+            for (int ph = 0; ph < kPhaseCount && n < static_cast<int>(sizeof(buf)); ++ph) {
+                Profiler::Summary sum = profiler.summary(static_cast<Phase>(ph));
+                n += std::snprintf(buf + n, sizeof(buf) - static_cast<size_t>(n), "%-8s %8.1f %8.1f\n",
+                                   Profiler::name(static_cast<Phase>(ph)), sum.p50Us, sum.p99Us);
             }
-        };
-
-        // Simple simultaneous-move resolution:
-        // - compute intended destinations and avoid allowing both players to move into the same tile
-        int p1_targetX = p1X + p1_dx, p1_targetY = p1Y + p1_dy;
-        int p2_targetX = p2X + p2_dx, p2_targetY = p2Y + p2_dy;
-
-        // If both intend to move into same tile, cancel both moves (could also pick priority)
-        bool conflictSameTile = (p1_dx != 0 || p1_dy != 0) && (p2_dx != 0 || p2_dy != 0)
-                                && (p1_targetX == p2_targetX && p1_targetY == p2_targetY);
-
-        // If they intend to swap positions (p1 -> p2 current and p2 -> p1 current) cancel both
-        bool swapPositions = (p1_targetX == p2X && p1_targetY == p2Y) &&
-                             (p2_targetX == p1X && p2_targetY == p1Y);
-
-        if (!conflictSameTile && !swapPositions) {
-            // apply both moves (order here matters if boxes involved; you might prefer atomic resolution)
-            try_move_player(p1X, p1Y, p1_dx, p1_dy, p2X, p2Y, 1);
-            try_move_player(p2X, p2Y, p2_dx, p2_dy, p1X, p1Y, 2);
-        } else {
-            // if conflict, no moves this frame; alternative: prioritize one player
+            profileText.setString(buf);
         }
 
-        // update sprite pixel positions
-        player1.setPosition(sf::Vector2f(p1X * TILE + 2.f, p1Y * TILE + 2.f));
-        player2.setPosition(sf::Vector2f(p2X * TILE + 2.f, p2Y * TILE + 2.f));
-
-        // Update score text
-        player1ScoreText.setString("Player 1: " + std::to_string(player1Score));
-        player2ScoreText.setString("Player 2: " + std::to_string(player2Score));
-
         // ---------- Drawing ----------
-        window.clear(sf::Color::Black);
-        for (int y = 0; y < MAP_H; ++y) for (int x = 0; x < MAP_W; ++x) window.draw(*tiles[y][x]);
-        window.draw(player1);
-        window.draw(player2);
-        
-        // Draw score display
-        window.draw(player1ScoreText);
-        window.draw(player2ScoreText);
-
-        // Draw timer
-        window.draw(timerText);
-
-        // If game over, show winner
-        if (gameOver) {
-            window.draw(winnerText);
+        {
+            ScopedTimer timer(&profiler, Phase::Draw);
+            TRACE_SCOPE("draw");
+            window.clear(sf::Color::Black);
+            window.draw(view);
+            if (showProfile) window.draw(profileText);
         }
-        
-        window.display();
-    }
 
-    // --- Free memory ---
-    for (int y = 0; y < MAP_H; ++y) {
-        for (int x = 0; x < MAP_W; ++x) {
-            delete tiles[y][x];
+        {
+            ScopedTimer timer(&profiler, Phase::Display);
+            TRACE_SCOPE("display");
+            window.display();
         }
-        delete[] tiles[y];
+
+        profiler.endFrame();
     }
-    delete[] tiles;
+
+    writeTrace();
+
+    const HudStats& hs = view.hud().stats();
+    std::cout << "hud: " << hs.updates << " updates, " << hs.rebuilds << " text rebuilds, avg "
+              << (hs.updates ? hs.totalNs / hs.updates : 0) << " ns/frame\n";
+
+    const InputLatencyStats& lat = inputQueue.latency();
+    std::cout << "input latency: " << lat.samples << " presses, avg " << lat.averageUs()
+              << " us, max " << lat.maxUs << " us, dropped " << lat.dropped << "\n";
 
     return 0;
-}
\ No newline at end of file
+}
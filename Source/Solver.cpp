@@ -0,0 +1,1054 @@
+// Solver.cpp
+#include "../include/Solver.hpp"
+#include "../include/Rng.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+constexpr int kInfinite = std::numeric_limits<int>::max() / 4;
+constexpr char kWalkChar[4] = { 'u', 'd', 'l', 'r' };
+constexpr char kPushChar[4] = { 'U', 'D', 'L', 'R' };
+
+// --- Open-addressing map from state hash to node index (A*) ---
+// Key 0 marks an empty slot, so a zero hash is stored as 1.
+class HashIndex {
+public:
+    HashIndex() { rehash(1 << 16); }
+
+    // Slot for 'key'; 'inserted' tells whether it was just created (value is then unset)
+    std::uint32_t& findOrInsert(std::uint64_t key, bool& inserted) {
+        if (key == 0) key = 1;
+        if ((count + 1) * 2 > keys.size()) rehash(keys.size() * 2);
+        std::size_t i = static_cast<std::size_t>(key) & mask;
+        while (keys[i] != 0 && keys[i] != key) i = (i + 1) & mask;
+        inserted = keys[i] == 0;
+        if (inserted) {
+            keys[i] = key;
+            ++count;
+        }
+        return values[i];
+    }
+
+    std::uint32_t find(std::uint64_t key) const {
+        if (key == 0) key = 1;
+        std::size_t i = static_cast<std::size_t>(key) & mask;
+        while (keys[i] != 0) {
+            if (keys[i] == key) return values[i];
+            i = (i + 1) & mask;
+        }
+        return std::numeric_limits<std::uint32_t>::max();
+    }
+
+private:
+    void rehash(std::size_t capacity) {
+        std::vector<std::uint64_t> oldKeys(capacity, 0);
+        std::vector<std::uint32_t> oldValues(capacity, 0);
+        oldKeys.swap(keys);
+        oldValues.swap(values);
+        mask = capacity - 1;
+        for (std::size_t j = 0; j < oldKeys.size(); ++j) {
+            if (oldKeys[j] == 0) continue;
+            std::size_t i = static_cast<std::size_t>(oldKeys[j]) & mask;
+            while (keys[i] != 0) i = (i + 1) & mask;
+            keys[i] = oldKeys[j];
+            values[i] = oldValues[j];
+        }
+    }
+
+    std::vector<std::uint64_t> keys;
+    std::vector<std::uint32_t> values;
+    std::size_t mask = 0;
+    std::size_t count = 0;
+};
+
+// --- A* search node; box lists live in a shared pool ---
+struct Node {
+    std::uint64_t hash;      // boxes + normalized player
+    std::uint32_t parent;
+    std::uint32_t boxOffset; // into the box pool
+    std::int32_t player;     // normalized (smallest reachable cell)
+    std::int32_t pushFrom;   // box cell before the push that created this node
+    std::uint16_t g;
+    std::uint16_t boxCount;
+    std::uint8_t dir;
+};
+
+constexpr std::uint32_t kNoParent = std::numeric_limits<std::uint32_t>::max();
+
+// --- Lock-free transposition table (IDA*) ---
+// Each entry is two independent atomic words; 'check' holds key ^ data, so an
+// entry torn by two racing writers fails the check and reads as a miss.
+class TranspositionTable {
+public:
+    // Entries carry their iteration, so a table is never cleared, only replaced when it grows
+    void resize(int bits) {
+        const std::size_t size = std::size_t(1) << bits;
+        if (entries && size == mask + 1) return;
+        entries.reset(new Entry[size]()); // value-init => zeroed
+        mask = size - 1;
+    }
+
+    // true if the state was already searched in this iteration at depth <= g; otherwise records it
+    bool seenOrStore(std::uint64_t key, int g, std::uint32_t iteration) {
+        Entry& e = entries[static_cast<std::size_t>(key) & mask];
+        const std::uint64_t data = e.data.load(std::memory_order_relaxed);
+        const std::uint64_t check = e.check.load(std::memory_order_relaxed);
+        if ((check ^ data) == key && (data >> 16) == iteration && static_cast<int>(data & 0xFFFF) <= g) return true;
+
+        const std::uint64_t fresh = static_cast<std::uint64_t>(g) | (static_cast<std::uint64_t>(iteration) << 16);
+        e.data.store(fresh, std::memory_order_relaxed);
+        e.check.store(key ^ fresh, std::memory_order_relaxed);
+        return false;
+    }
+
+private:
+    struct Entry {
+        std::atomic<std::uint64_t> check;
+        std::atomic<std::uint64_t> data; // g (16 bits) | iteration << 16
+    };
+    std::unique_ptr<Entry[]> entries;
+    std::size_t mask = 0;
+};
+
+// A subtree root handed between IDA* workers
+struct IdaTask {
+    std::vector<int> boxes;
+    std::vector<std::pair<int, int>> path; // pushes from the start to here
+    int player = 0;
+    int g = 0;
+};
+
+// Below this many pushes from the start, parallel IDA* turns children into tasks
+// instead of recursing; a few hundred subtrees per iteration keeps every worker fed
+constexpr int kSplitDepth = 4;
+
+} // namespace
+
+// --- Min-cost box-to-goal matching (standard rules) ---
+// Kept with its dual potentials, so a child state repairs its parent's matching
+// with one augmentation instead of solving from scratch.
+struct Solver::Assignment {
+    Assignment(std::size_t boxCount, std::size_t goalCount)
+    : potentialBox(boxCount + 1)
+    , goalOfBox(boxCount + 1)
+    , potentialGoal(goalCount + 1)
+    , matchOfGoal(goalCount + 1)
+    {}
+
+    int cost(const std::vector<std::vector<int>>& goalDistance, const int* cells) const {
+        int sum = 0;
+        for (std::size_t j = 1; j < matchOfGoal.size(); ++j) {
+            const int i = matchOfGoal[j];
+            if (i) sum += goalDistance[j - 1][static_cast<std::size_t>(cells[i - 1])];
+        }
+        return std::min(sum, kInfinite);
+    }
+
+    std::vector<int> potentialBox, goalOfBox;    // [box + 1]
+    std::vector<int> potentialGoal, matchOfGoal; // [goal + 1]; matchOfGoal holds a 1-based box, 0 = free
+};
+
+// --- Per-thread search state: scratch grids, the in-place IDA* state and a task deque ---
+// The owner takes tasks from the back of its deque (depth-first), thieves take
+// from the front (the oldest, largest subtrees). Tasks are whole subtrees cut
+// only in the first kSplitDepth pushes, a few dozen per iteration against up to
+// millions of expansions, so a mutex per deque is taken rarely and a lock-free
+// (Chase-Lev) deque would not pay for itself.
+struct Solver::Worker {
+    Worker(std::size_t cells, std::size_t boxCount, std::size_t goalCount)
+    : reachStamp(cells, 0)
+    , queue(cells)
+    , corralOf(cells, 0)
+    , assignment(boxCount, goalCount)
+    , childAssignment(boxCount, goalCount)
+    , wayOfGoal(goalCount + 1)
+    , slack(goalCount + 1)
+    , goalUsed(goalCount + 1)
+    {
+        boxAt.resize(static_cast<int>(cells));
+    }
+
+    bool reachable(int cell) const { return reachStamp[static_cast<std::size_t>(cell)] == stamp; }
+
+    CellBitset boxAt;
+    std::vector<std::uint32_t> reachStamp; // stamp-based flood fill: nothing is cleared between states
+    std::vector<int> queue;
+    std::uint32_t stamp = 0;
+    std::vector<std::uint32_t> corralOf; // cell -> corral label; labels only grow, so nothing is cleared
+    std::uint32_t corralLabel = 0;
+
+    // Hungarian assignment: the expanded node's matching, a child's, and scratch
+    Assignment assignment;
+    Assignment childAssignment;
+    std::vector<int> wayOfGoal, slack;
+    std::vector<std::uint8_t> goalUsed;
+    std::vector<Assignment> assignmentAtDepth; // IDA*: the matching of each state on the path
+
+    // IDA* state (in-place make/unmake)
+    std::vector<int> boxes;
+    std::vector<std::vector<Push>> pushesAtDepth;
+    std::vector<std::pair<int, int>> path;
+    std::uint64_t boxHash = 0;
+    int heuristic = 0;
+    int player = 0;
+    int nextBound = 0;
+    std::uint64_t unflushed = 0; // expansions not yet added to IdaShared::nodes
+
+    std::mutex taskMutex;
+    std::deque<IdaTask> tasks;
+};
+
+struct Solver::IdaShared {
+    const SolverOptions& options;
+    TranspositionTable& table;
+    std::uint32_t iteration;
+    int bound;
+    int splitDepth; // 0 => plain recursion (the deterministic single-thread search)
+    int threadCount;
+
+    std::atomic<int> pending{ 0 };          // tasks queued or running
+    std::atomic<int> queued{ 0 };           // tasks in some deque, not yet taken
+    std::atomic<bool> stop{ false };        // solution found or node budget spent
+    std::atomic<bool> outOfNodes{ false };
+    std::atomic<std::uint64_t> nodes{ 0 };  // flushed in batches by the workers
+
+    // Workers with nothing to take sleep here until a task is queued, the last
+    // task finishes or the search stops
+    std::mutex idleMutex;
+    std::condition_variable idle;
+
+    std::mutex solutionMutex;
+    bool solved = false;
+    std::vector<std::pair<int, int>> solution;
+
+    IdaShared(const SolverOptions& options, TranspositionTable& table, std::uint32_t iteration, int bound,
+              int splitDepth, int threadCount)
+    : options(options), table(table), iteration(iteration), bound(bound), splitDepth(splitDepth), threadCount(threadCount)
+    {}
+
+    void wakeIdle(bool all) {
+        std::lock_guard<std::mutex> lock(idleMutex); // a sleeper is either waiting or about to see the change
+        if (all) idle.notify_all();
+        else idle.notify_one();
+    }
+
+    void halt() {
+        stop.store(true, std::memory_order_relaxed);
+        wakeIdle(true);
+    }
+};
+
+// Threads 1..n-1 wait for the next iteration, run it and report back; the
+// calling thread runs worker 0 itself. Started once per solve, so deepening the
+// bound costs a wake-up, not a thread start.
+struct Solver::IdaPool {
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    IdaShared* shared = nullptr; // the current iteration
+    std::uint64_t generation = 0;
+    int running = 0;
+    bool stopping = false;
+
+    ~IdaPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (std::thread& t : threads) t.join();
+    }
+
+    // Runs 'shared' on threads 1..n-1 while the caller runs worker 0
+    template <class RunFirst>
+    void run(IdaShared& iteration, RunFirst runFirst) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            shared = &iteration;
+            ++generation;
+            running = static_cast<int>(threads.size());
+        }
+        wake.notify_all();
+        runFirst();
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [this] { return running == 0; });
+    }
+};
+
+Solver::Solver(const PuzzleLevel& level)
+: rules(level.rules)
+, levelWidth(level.width)
+, width(level.width + 2)
+, height(level.height + 2)
+, startPlayer(-1)
+{
+    offsets[0] = -width;
+    offsets[1] = width;
+    offsets[2] = -1;
+    offsets[3] = 1;
+
+    const std::size_t count = static_cast<std::size_t>(width * height);
+    walls.assign(count, 1);
+    goals.assign(count, 0);
+
+    for (int lc = 0; lc < level.width * level.height; ++lc) {
+        const std::size_t c = static_cast<std::size_t>(cellOf(lc));
+        walls[c] = level.isWall(lc) ? 1 : 0;
+        goals[c] = level.isGoal(lc) ? 1 : 0;
+    }
+    for (int b : level.boxes) startBoxes.push_back(cellOf(b));
+    if (level.player >= 0) startPlayer = cellOf(level.player);
+
+    // Fixed seed: the same level always hashes the same way
+    Rng rng(0x5EA2C4, 0);
+    boxKeys.resize(count);
+    playerKeys.resize(count);
+    for (std::size_t c = 0; c < count; ++c) {
+        boxKeys[c] = rng.next();
+        playerKeys[c] = rng.next();
+    }
+
+    std::vector<std::uint8_t> board(count);
+    for (std::size_t c = 0; c < count; ++c) {
+        board[c] = (walls[c] ? DeadlockTable::kWall : 0) | (goals[c] ? DeadlockTable::kGoal : 0);
+    }
+    deadlocks.build(width, height, board.data());
+
+    computeDistances();
+    workers.push_back(std::make_unique<Worker>(count, startBoxes.size(), goalCells.size()));
+}
+
+Solver::~Solver() = default;
+
+int Solver::cellOf(int levelCell) const {
+    return (levelCell / levelWidth + 1) * width + levelCell % levelWidth + 1;
+}
+
+int Solver::pushDistance(int x, int y) const {
+    const int d = distance[static_cast<std::size_t>(cellOf(y * levelWidth + x))];
+    return d >= kInfinite ? -1 : d;
+}
+
+void Solver::computeDistances() {
+    distance.assign(walls.size(), kInfinite);
+    goalCells.clear();
+    goalDistance.clear();
+    for (int c = 0; c < width * height; ++c) {
+        if (!goals[static_cast<std::size_t>(c)] || walls[static_cast<std::size_t>(c)]) continue;
+        goalCells.push_back(c);
+        goalDistance.emplace_back();
+        pullFrom(c, goalDistance.back());
+        for (std::size_t i = 0; i < distance.size(); ++i) distance[i] = std::min(distance[i], goalDistance.back()[i]);
+    }
+}
+
+// Pull a box away from 'goal': a box at 'from' pushed in direction d lands on 'to'
+// if 'from' is free and the player fits behind it. Ignores other boxes, so the
+// result is a lower bound; unreached cells can never bring a box to this goal.
+void Solver::pullFrom(int goal, std::vector<int>& out) {
+    out.assign(walls.size(), kInfinite);
+    std::vector<int> frontier(1, goal);
+    out[static_cast<std::size_t>(goal)] = 0;
+    for (std::size_t head = 0; head < frontier.size(); ++head) {
+        const int to = frontier[head];
+        for (int d = 0; d < 4; ++d) {
+            const int from = to - offsets[d];
+            if (walls[static_cast<std::size_t>(from)]) continue;
+            if (walls[static_cast<std::size_t>(from - offsets[d])]) continue; // no room for the player
+            if (out[static_cast<std::size_t>(from)] != kInfinite) continue;
+            out[static_cast<std::size_t>(from)] = out[static_cast<std::size_t>(to)] + 1;
+            frontier.push_back(from);
+        }
+    }
+}
+
+int Solver::reach(Worker& w, int from) const {
+    if (++w.stamp == 0) {
+        std::fill(w.reachStamp.begin(), w.reachStamp.end(), 0);
+        w.stamp = 1;
+    }
+    int head = 0;
+    int tail = 0;
+    int smallest = from;
+    w.reachStamp[static_cast<std::size_t>(from)] = w.stamp;
+    w.queue[static_cast<std::size_t>(tail++)] = from;
+    while (head < tail) {
+        const int c = w.queue[static_cast<std::size_t>(head++)];
+        for (int d = 0; d < 4; ++d) {
+            const int n = c + offsets[d];
+            const std::size_t ni = static_cast<std::size_t>(n);
+            if (walls[ni] || w.boxAt.test(n) || w.reachStamp[ni] == w.stamp) continue;
+            w.reachStamp[ni] = w.stamp;
+            w.queue[static_cast<std::size_t>(tail++)] = n;
+            smallest = std::min(smallest, n);
+        }
+    }
+    return smallest;
+}
+
+void Solver::collectPushes(Worker& w, std::vector<Push>& out) const {
+    for (int i = 0; i < static_cast<int>(w.boxes.size()); ++i) {
+        const int b = w.boxes[static_cast<std::size_t>(i)];
+        for (int d = 0; d < 4; ++d) {
+            const int to = b + offsets[d];
+            if (!w.reachable(b - offsets[d])) continue;
+            if (walls[static_cast<std::size_t>(to)] || w.boxAt.test(to) || deadlocks.isDead(to)) continue;
+            out.push_back({ i, d });
+        }
+    }
+    if (out.size() > 1) restrictToCorral(w, out);
+}
+
+// --- PI-corral pruning ---
+// A corral is floor the player can't reach, fenced by boxes. If every legal push
+// of a fence box goes into the corral (I) and the player can already make every
+// push into it (P), nothing done outside can open it another way: it has to be
+// entered sooner or later, and doing it first costs no extra pushes. So when
+// such a corral still needs work (a fence box off its goal, or a goal inside),
+// only the pushes into it are searched; with several, the one with fewest.
+void Solver::restrictToCorral(Worker& w, std::vector<Push>& pushes) const {
+    if (w.corralLabel > std::numeric_limits<std::uint32_t>::max() - static_cast<std::uint32_t>(walls.size())) {
+        std::fill(w.corralOf.begin(), w.corralOf.end(), 0);
+        w.corralLabel = 0;
+    }
+    const std::uint32_t firstLabel = w.corralLabel + 1;
+    std::uint32_t best = 0;
+    std::size_t bestCount = pushes.size();
+
+    auto inCorral = [&w](int cell, std::uint32_t label) { return w.corralOf[static_cast<std::size_t>(cell)] == label; };
+    auto fencesCorral = [&](int box, std::uint32_t label) {
+        for (int d = 0; d < 4; ++d) {
+            if (inCorral(box + offsets[d], label)) return true;
+        }
+        return false;
+    };
+
+    // Every corral touches a box, so seeding from the boxes' neighbors finds them all
+    for (int b : w.boxes) {
+        for (int side = 0; side < 4; ++side) {
+            const int seed = b + offsets[side];
+            const std::size_t si = static_cast<std::size_t>(seed);
+            if (walls[si] || w.boxAt.test(seed) || w.reachable(seed) || w.corralOf[si] >= firstLabel) continue;
+
+            // --- Flood the corral ---
+            const std::uint32_t label = ++w.corralLabel;
+            bool needsWork = rules == PuzzleRules::Portal; // portal boxes never rest on a goal
+            int tail = 0;
+            w.corralOf[si] = label;
+            w.queue[static_cast<std::size_t>(tail++)] = seed;
+            for (int head = 0; head < tail; ++head) {
+                const int c = w.queue[static_cast<std::size_t>(head)];
+                if (goals[static_cast<std::size_t>(c)]) needsWork = true; // an empty goal inside
+                for (int d = 0; d < 4; ++d) {
+                    const int n = c + offsets[d];
+                    const std::size_t ni = static_cast<std::size_t>(n);
+                    if (walls[ni] || w.corralOf[ni] == label) continue;
+                    if (w.boxAt.test(n)) {
+                        if (!goals[ni]) needsWork = true;
+                        continue;
+                    }
+                    w.corralOf[ni] = label;
+                    w.queue[static_cast<std::size_t>(tail++)] = n;
+                }
+            }
+            if (!needsWork) continue;
+
+            // I: every legal push of a fence box ends inside
+            std::size_t count = 0;
+            bool valid = true;
+            for (const Push& push : pushes) {
+                const int from = w.boxes[static_cast<std::size_t>(push.box)];
+                if (!fencesCorral(from, label)) continue;
+                if (!inCorral(from + offsets[push.dir], label)) {
+                    valid = false;
+                    break;
+                }
+                ++count;
+            }
+            if (!valid || count == 0 || count >= bestCount) continue;
+
+            // P: every push into the corral can be made from where the player is
+            for (int fence : w.boxes) {
+                for (int d = 0; d < 4 && valid; ++d) {
+                    const int to = fence + offsets[d];
+                    const int behind = fence - offsets[d];
+                    if (!inCorral(to, label) || deadlocks.isDead(to) || walls[static_cast<std::size_t>(behind)]) continue;
+                    valid = w.reachable(behind);
+                }
+                if (!valid) break;
+            }
+            if (!valid) continue;
+            best = label;
+            bestCount = count;
+        }
+    }
+    if (!best) return;
+
+    pushes.erase(std::remove_if(pushes.begin(), pushes.end(),
+                                [&](const Push& push) {
+                                    const int from = w.boxes[static_cast<std::size_t>(push.box)];
+                                    return !fencesCorral(from, best) || !inCorral(from + offsets[push.dir], best);
+                                }),
+                 pushes.end());
+}
+
+std::uint64_t Solver::boxHashOf(const int* cells, int count) const {
+    std::uint64_t h = 0;
+    for (int i = 0; i < count; ++i) h ^= boxKeys[static_cast<std::size_t>(cells[i])];
+    return h;
+}
+
+int Solver::nearestGoalSum(const int* cells, int count) const {
+    int h = 0;
+    for (int i = 0; i < count; ++i) h += distance[static_cast<std::size_t>(cells[i])];
+    return std::min(h, kInfinite);
+}
+
+int Solver::heuristicOf(Worker& w, Assignment& a, const int* cells, int count) const {
+    if (rules == PuzzleRules::Portal) return nearestGoalSum(cells, count);
+
+    std::fill(a.potentialBox.begin(), a.potentialBox.end(), 0);
+    std::fill(a.potentialGoal.begin(), a.potentialGoal.end(), 0);
+    std::fill(a.matchOfGoal.begin(), a.matchOfGoal.end(), 0);
+    for (int i = 1; i <= count; ++i) {
+        if (!augment(w, a, cells, i)) return kInfinite;
+    }
+    return a.cost(goalDistance, cells);
+}
+
+// Only one box moved, so only its row of the cost matrix changed: unmatch it,
+// lower its potential until every reduced cost is nonnegative again, and run a
+// single augmentation. O(goals^2) instead of O(boxes * goals^2) from scratch.
+int Solver::heuristicAfterPush(Worker& w, const Assignment& parent, Assignment& a, const int* cells, int count,
+                               int moved) const {
+    if (rules == PuzzleRules::Portal) return nearestGoalSum(cells, count);
+
+    a = parent;
+    const int row = moved + 1;
+    const std::size_t box = static_cast<std::size_t>(cells[moved]);
+    a.matchOfGoal[static_cast<std::size_t>(a.goalOfBox[static_cast<std::size_t>(row)])] = 0;
+    int potential = kInfinite;
+    for (std::size_t j = 1; j < a.potentialGoal.size(); ++j) {
+        potential = std::min(potential, goalDistance[j - 1][box] - a.potentialGoal[j]);
+    }
+    if (potential >= kInfinite / 2) return kInfinite;
+    a.potentialBox[static_cast<std::size_t>(row)] = potential;
+    if (!augment(w, a, cells, row)) return kInfinite;
+    return a.cost(goalDistance, cells);
+}
+
+// Hungarian method (potentials form): match box 'row' (1-based) along a shortest
+// augmenting path over reduced costs. Boxes are rows, goals are columns, and
+// column 0 is a virtual start. False if the box can reach no free goal.
+bool Solver::augment(Worker& w, Assignment& a, const int* cells, int row) const {
+    const int goalCount = static_cast<int>(goalCells.size());
+    a.matchOfGoal[0] = row;
+    int j0 = 0;
+    std::fill(w.slack.begin(), w.slack.end(), kInfinite);
+    std::fill(w.goalUsed.begin(), w.goalUsed.end(), 0);
+    do {
+        w.goalUsed[static_cast<std::size_t>(j0)] = 1;
+        const int i0 = a.matchOfGoal[static_cast<std::size_t>(j0)];
+        const std::size_t box = static_cast<std::size_t>(cells[i0 - 1]);
+        int delta = kInfinite;
+        int j1 = -1;
+        for (int j = 1; j <= goalCount; ++j) {
+            const std::size_t sj = static_cast<std::size_t>(j);
+            if (w.goalUsed[sj]) continue;
+            const int cur = goalDistance[sj - 1][box] - a.potentialBox[static_cast<std::size_t>(i0)] - a.potentialGoal[sj];
+            if (cur < w.slack[sj]) {
+                w.slack[sj] = cur;
+                w.wayOfGoal[sj] = j0;
+            }
+            if (w.slack[sj] < delta) {
+                delta = w.slack[sj];
+                j1 = j;
+            }
+        }
+        if (j1 < 0 || delta >= kInfinite / 2) return false;
+        for (int j = 0; j <= goalCount; ++j) {
+            const std::size_t sj = static_cast<std::size_t>(j);
+            if (w.goalUsed[sj]) {
+                a.potentialBox[static_cast<std::size_t>(a.matchOfGoal[sj])] += delta;
+                a.potentialGoal[sj] -= delta;
+            } else {
+                w.slack[sj] -= delta;
+            }
+        }
+        j0 = j1;
+    } while (a.matchOfGoal[static_cast<std::size_t>(j0)] != 0);
+    do {
+        const int j1 = w.wayOfGoal[static_cast<std::size_t>(j0)];
+        a.matchOfGoal[static_cast<std::size_t>(j0)] = a.matchOfGoal[static_cast<std::size_t>(j1)];
+        j0 = j1;
+    } while (j0 != 0);
+    for (int j = 1; j <= goalCount; ++j) {
+        const int i = a.matchOfGoal[static_cast<std::size_t>(j)];
+        if (i) a.goalOfBox[static_cast<std::size_t>(i)] = j;
+    }
+    return true;
+}
+
+bool Solver::consumes(int cell) const {
+    return rules == PuzzleRules::Portal && goals[static_cast<std::size_t>(cell)];
+}
+
+SolverResult Solver::solve(const SolverOptions& options) {
+    const auto start = std::chrono::steady_clock::now();
+    SolverResult result;
+
+    // Trivially impossible: no player, a box already on a dead square, or too few goals
+    const int goalCount = static_cast<int>(goalCells.size());
+    const bool tooFewGoals = rules == PuzzleRules::Standard ? goalCount < static_cast<int>(startBoxes.size())
+                                                            : goalCount == 0 && !startBoxes.empty();
+    if (startPlayer < 0 || tooFewGoals
+        || heuristicOf(*workers[0], workers[0]->assignment, startBoxes.data(), static_cast<int>(startBoxes.size())) >= kInfinite) {
+        result.unsolvable = true;
+        return result;
+    }
+
+    result = options.algorithm == SearchAlgorithm::IdaStar ? solveIdaStar(options) : solveAStar(options);
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+SolverResult Solver::solveAStar(const SolverOptions& options) {
+    SolverResult result;
+    Worker& w = *workers[0];
+    std::vector<Node> nodes;
+    std::vector<int> pool;
+    // Buckets per f, then per h: among equal f the node nearest the goal goes
+    // first (deepest), LIFO inside a bucket
+    std::vector<std::vector<std::vector<std::uint32_t>>> open;
+    HashIndex index;
+    std::vector<Push> pushes;
+    std::vector<int> childBoxes;
+    std::uint64_t expanded = 0;
+
+    auto placeBoxes = [&w](const std::vector<int>& cells, bool on) {
+        for (int c : cells) w.boxAt.assign(c, on);
+    };
+
+    // --- Root ---
+    const int boxCount = static_cast<int>(startBoxes.size());
+    placeBoxes(startBoxes, true);
+    Node root{};
+    root.player = reach(w, startPlayer);
+    placeBoxes(startBoxes, false);
+    root.hash = boxHashOf(startBoxes.data(), boxCount) ^ playerKeys[static_cast<std::size_t>(root.player)];
+    root.parent = kNoParent;
+    root.boxCount = static_cast<std::uint16_t>(boxCount);
+    pool.insert(pool.end(), startBoxes.begin(), startBoxes.end());
+    nodes.push_back(root);
+    bool inserted = false;
+    index.findOrInsert(root.hash, inserted) = 0;
+
+    const std::size_t h0 = static_cast<std::size_t>(heuristicOf(w, w.assignment, startBoxes.data(), boxCount));
+    open.resize(h0 + 1);
+    open[h0].resize(h0 + 1);
+    open[h0][h0].push_back(0);
+
+    for (std::size_t f = h0; f < open.size(); ) {
+        std::vector<std::vector<std::uint32_t>>& byH = open[f];
+        std::size_t h = 0;
+        while (h < byH.size() && byH[h].empty()) ++h;
+        if (h == byH.size()) {
+            ++f;
+            continue;
+        }
+        const std::uint32_t n = byH[h].back();
+        byH[h].pop_back();
+        const Node node = nodes[n]; // copy: 'nodes' grows below
+        if (index.find(node.hash) != n) continue; // superseded by a cheaper path
+
+        const int* nodeBoxes = pool.data() + node.boxOffset;
+        if (h == 0) {
+            std::vector<std::pair<int, int>> path;
+            for (std::uint32_t i = n; nodes[i].parent != kNoParent; i = nodes[i].parent) {
+                path.emplace_back(nodes[i].pushFrom, nodes[i].dir);
+            }
+            std::reverse(path.begin(), path.end());
+            result.solved = true;
+            result.pushes = static_cast<int>(path.size());
+            result.solution = toLurd(path);
+            break;
+        }
+        if (expanded >= options.maxNodes) break;
+        ++expanded;
+
+        // --- Expand: legal pushes from the player's reachable region ---
+        heuristicOf(w, w.assignment, nodeBoxes, node.boxCount); // the matching children repair
+        w.boxes.assign(nodeBoxes, nodeBoxes + node.boxCount);
+        placeBoxes(w.boxes, true);
+        reach(w, node.player);
+        pushes.clear();
+        collectPushes(w, pushes);
+
+        const std::uint64_t nodeBoxHash = node.hash ^ playerKeys[static_cast<std::size_t>(node.player)];
+        for (const Push& push : pushes) {
+            const int from = w.boxes[static_cast<std::size_t>(push.box)];
+            const int to = from + offsets[push.dir];
+            const bool consumed = consumes(to);
+
+            childBoxes = w.boxes;
+            if (consumed) {
+                childBoxes[static_cast<std::size_t>(push.box)] = childBoxes.back();
+                childBoxes.pop_back();
+            } else {
+                childBoxes[static_cast<std::size_t>(push.box)] = to;
+            }
+
+            // Normalize the player: flood fill from where the box was. A push that
+            // freezes a box off its goal is dropped before any further work.
+            w.boxAt.reset(from);
+            if (!consumed) w.boxAt.set(to);
+            const bool frozen = !consumed && deadlocks.isFreezeDeadlock(w.boxAt, to);
+            const int childPlayer = frozen ? 0 : reach(w, from);
+            if (!consumed) w.boxAt.reset(to);
+            w.boxAt.set(from);
+            if (frozen) continue;
+
+            std::uint64_t childHash = nodeBoxHash ^ boxKeys[static_cast<std::size_t>(from)];
+            if (!consumed) childHash ^= boxKeys[static_cast<std::size_t>(to)];
+            childHash ^= playerKeys[static_cast<std::size_t>(childPlayer)];
+
+            const int childH = heuristicAfterPush(w, w.assignment, w.childAssignment, childBoxes.data(),
+                                                  static_cast<int>(childBoxes.size()), push.box);
+            if (childH >= kInfinite) continue; // boxes can't all get a goal from here
+
+            const int g = node.g + 1;
+            std::uint32_t& slot = index.findOrInsert(childHash, inserted);
+            if (!inserted && nodes[slot].g <= g) continue;
+
+            Node child{};
+            child.hash = childHash;
+            child.parent = n;
+            child.boxOffset = static_cast<std::uint32_t>(pool.size());
+            child.player = childPlayer;
+            child.pushFrom = from;
+            child.g = static_cast<std::uint16_t>(g);
+            child.boxCount = static_cast<std::uint16_t>(childBoxes.size());
+            child.dir = static_cast<std::uint8_t>(push.dir);
+            slot = static_cast<std::uint32_t>(nodes.size());
+            nodes.push_back(child);
+            pool.insert(pool.end(), childBoxes.begin(), childBoxes.end());
+
+            const std::size_t childF = static_cast<std::size_t>(g + childH);
+            if (childF >= open.size()) open.resize(childF + 1);
+            if (open[childF].size() <= static_cast<std::size_t>(childH)) open[childF].resize(childF + 1);
+            open[childF][static_cast<std::size_t>(childH)].push_back(slot);
+        }
+        placeBoxes(w.boxes, false);
+    }
+
+    result.unsolvable = !result.solved && expanded < options.maxNodes;
+    result.nodes = expanded;
+    return result;
+}
+
+SolverResult Solver::solveIdaStar(const SolverOptions& options) {
+    SolverResult result;
+    int threadCount = options.threads > 0 ? options.threads : static_cast<int>(std::thread::hardware_concurrency());
+    threadCount = std::max(1, threadCount);
+    result.threads = threadCount;
+    while (static_cast<int>(workers.size()) < threadCount) {
+        workers.push_back(std::make_unique<Worker>(walls.size(), startBoxes.size(), goalCells.size()));
+    }
+    for (std::unique_ptr<Worker>& w : workers) {
+        w->unflushed = 0;
+    }
+
+    // Start small and grow with the iterations up to options.tableBits, so an easy
+    // level doesn't pay for allocating and zeroing the full table
+    const int maxTableBits = std::max(10, std::min(options.tableBits, 30));
+    int tableBits = std::min(maxTableBits, 16);
+    TranspositionTable table;
+    table.resize(tableBits);
+    const int splitDepth = threadCount > 1 ? kSplitDepth : 0;
+    std::uint64_t flushedNodes = 0;
+
+    IdaPool pool; // joined on every way out of this function
+    for (int i = 1; i < threadCount; ++i) pool.threads.emplace_back(&Solver::runIdaThread, this, i, std::ref(pool));
+
+    // Deepen the f bound to the smallest f that exceeded it last time
+    int bound = heuristicOf(*workers[0], workers[0]->assignment, startBoxes.data(), static_cast<int>(startBoxes.size()));
+    for (std::uint32_t iteration = 1; ; ++iteration) {
+        const std::uint64_t nodesBefore = flushedNodes;
+        IdaShared shared(options, table, iteration, bound, splitDepth, threadCount);
+        shared.nodes.store(flushedNodes, std::memory_order_relaxed);
+        for (int i = 0; i < threadCount; ++i) {
+            Worker& w = *workers[static_cast<std::size_t>(i)];
+            w.nextBound = kInfinite;
+            w.tasks.clear();
+            // g never exceeds the bound; sized up front since deeper frames must not move this
+            if (static_cast<int>(w.pushesAtDepth.size()) <= bound) w.pushesAtDepth.resize(static_cast<std::size_t>(bound) + 1);
+            if (static_cast<int>(w.assignmentAtDepth.size()) <= bound + 1) {
+                w.assignmentAtDepth.resize(static_cast<std::size_t>(bound) + 2, w.assignment);
+            }
+        }
+        IdaTask root;
+        root.boxes = startBoxes;
+        root.player = startPlayer;
+        workers[0]->tasks.push_back(std::move(root));
+        shared.pending.store(1, std::memory_order_relaxed);
+        shared.queued.store(1, std::memory_order_relaxed);
+
+        pool.run(shared, [&] { runIdaWorker(0, shared); });
+        flushedNodes = shared.nodes.load(std::memory_order_relaxed);
+
+        if (shared.solved) {
+            result.solved = true;
+            result.pushes = static_cast<int>(shared.solution.size());
+            result.solution = toLurd(shared.solution);
+            break;
+        }
+        if (shared.outOfNodes.load(std::memory_order_relaxed)) break;
+
+        int nextBound = kInfinite;
+        for (int i = 0; i < threadCount; ++i) nextBound = std::min(nextBound, workers[static_cast<std::size_t>(i)]->nextBound);
+        if (nextBound >= kInfinite) {
+            result.unsolvable = true;
+            break;
+        }
+        bound = nextBound;
+
+        // The next iteration visits at least as many states as this one
+        while (tableBits < maxTableBits && (std::uint64_t(1) << tableBits) < (flushedNodes - nodesBefore) * 2) ++tableBits;
+        table.resize(tableBits);
+    }
+
+    result.nodes = flushedNodes;
+    return result;
+}
+
+void Solver::runIdaThread(int index, IdaPool& pool) {
+    std::uint64_t seen = 0;
+    for (;;) {
+        IdaShared* shared = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(pool.mutex);
+            pool.wake.wait(lock, [&] { return pool.stopping || pool.generation != seen; });
+            if (pool.stopping) return;
+            seen = pool.generation;
+            shared = pool.shared;
+        }
+        runIdaWorker(index, *shared);
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        if (--pool.running == 0) pool.finished.notify_one();
+    }
+}
+
+// One worker's share of an iteration: run own tasks depth-first, steal when
+// empty, sleep while every queued task is taken but some are still running
+void Solver::runIdaWorker(int index, IdaShared& shared) {
+    Worker& w = *workers[static_cast<std::size_t>(index)];
+    IdaTask task;
+    int victim = index;
+
+    while (!shared.stop.load(std::memory_order_relaxed)) {
+        bool haveTask = false;
+        {
+            std::lock_guard<std::mutex> lock(w.taskMutex);
+            if (!w.tasks.empty()) {
+                task = std::move(w.tasks.back());
+                w.tasks.pop_back();
+                haveTask = true;
+            }
+        }
+        for (int tries = 1; !haveTask && tries < shared.threadCount; ++tries) {
+            victim = (victim + 1) % shared.threadCount;
+            if (victim == index) continue;
+            Worker& other = *workers[static_cast<std::size_t>(victim)];
+            std::lock_guard<std::mutex> lock(other.taskMutex);
+            if (!other.tasks.empty()) {
+                task = std::move(other.tasks.front());
+                other.tasks.pop_front();
+                haveTask = true;
+            }
+        }
+        if (!haveTask) {
+            std::unique_lock<std::mutex> lock(shared.idleMutex);
+            shared.idle.wait(lock, [&] {
+                return shared.queued.load(std::memory_order_acquire) > 0 || shared.pending.load(std::memory_order_acquire) == 0
+                       || shared.stop.load(std::memory_order_relaxed);
+            });
+            if (shared.pending.load(std::memory_order_acquire) == 0) break;
+            continue;
+        }
+        shared.queued.fetch_sub(1, std::memory_order_relaxed);
+
+        // --- Load the subtree root into this worker's in-place state ---
+        w.boxes = std::move(task.boxes);
+        w.path = std::move(task.path);
+        w.player = task.player;
+        for (int c : w.boxes) w.boxAt.set(c);
+        w.boxHash = boxHashOf(w.boxes.data(), static_cast<int>(w.boxes.size()));
+        w.heuristic = heuristicOf(w, w.assignmentAtDepth[static_cast<std::size_t>(task.g)], w.boxes.data(),
+                                  static_cast<int>(w.boxes.size()));
+
+        if (idaSearch(w, task.g, shared)) {
+            {
+                std::lock_guard<std::mutex> lock(shared.solutionMutex);
+                if (!shared.solved) {
+                    shared.solved = true;
+                    shared.solution = w.path;
+                }
+            }
+            shared.halt();
+        }
+        for (int c : w.boxes) w.boxAt.reset(c);
+        if (shared.pending.fetch_sub(1, std::memory_order_acq_rel) == 1) shared.wakeIdle(true); // iteration done
+    }
+
+    shared.nodes.fetch_add(w.unflushed, std::memory_order_relaxed);
+    w.unflushed = 0;
+}
+
+bool Solver::idaSearch(Worker& w, int g, IdaShared& shared) {
+    const int f = g + w.heuristic;
+    if (f > shared.bound) {
+        w.nextBound = std::min(w.nextBound, f);
+        return false;
+    }
+    if (w.heuristic == 0) return true;
+
+    // Node budget: exact with one worker, checked per 1024-node batch with several
+    if (shared.nodes.load(std::memory_order_relaxed) + w.unflushed >= shared.options.maxNodes) {
+        shared.outOfNodes.store(true, std::memory_order_relaxed);
+        shared.halt();
+        return false;
+    }
+    if (++w.unflushed == 1024) {
+        shared.nodes.fetch_add(w.unflushed, std::memory_order_relaxed);
+        w.unflushed = 0;
+    }
+
+    // Transposition: the same state was already searched at this or a smaller depth
+    const std::uint64_t key = w.boxHash ^ playerKeys[static_cast<std::size_t>(reach(w, w.player))];
+    if (shared.table.seenOrStore(key, g, shared.iteration)) return false;
+
+    std::vector<Push>& pushes = w.pushesAtDepth[static_cast<std::size_t>(g)];
+    pushes.clear();
+    collectPushes(w, pushes); // uses the reach() above; children overwrite it
+    const bool split = g < shared.splitDepth;
+
+    for (std::size_t k = 0; k < pushes.size(); ++k) {
+        const Push push = pushes[k];
+        const std::size_t i = static_cast<std::size_t>(push.box);
+        const int from = w.boxes[i];
+        const int to = from + offsets[push.dir];
+        const bool consumed = consumes(to);
+
+        // --- Make ---
+        w.boxAt.reset(from);
+        w.boxHash ^= boxKeys[static_cast<std::size_t>(from)];
+        const int last = w.boxes.back();
+        if (consumed) {
+            w.boxes[i] = last;
+            w.boxes.pop_back();
+        } else {
+            w.boxes[i] = to;
+            w.boxAt.set(to);
+            w.boxHash ^= boxKeys[static_cast<std::size_t>(to)];
+        }
+        const int savedHeuristic = w.heuristic;
+        const bool frozen = !consumed && deadlocks.isFreezeDeadlock(w.boxAt, to);
+        w.heuristic = frozen ? kInfinite
+                             : heuristicAfterPush(w, w.assignmentAtDepth[static_cast<std::size_t>(g)],
+                                                  w.assignmentAtDepth[static_cast<std::size_t>(g) + 1], w.boxes.data(),
+                                                  static_cast<int>(w.boxes.size()), push.box);
+        const int savedPlayer = w.player;
+        w.player = from;
+        w.path.emplace_back(from, push.dir);
+
+        // A frozen box or one with no goal left makes the child unsolvable; skip it without counting a bound
+        if (w.heuristic < kInfinite) {
+            if (!split) {
+                if (idaSearch(w, g + 1, shared)) return true;
+            } else if (g + 1 + w.heuristic > shared.bound) {
+                w.nextBound = std::min(w.nextBound, g + 1 + w.heuristic);
+            } else {
+                // Hand the subtree to the deque; the owner or a thief searches it
+                IdaTask task;
+                task.boxes = w.boxes;
+                task.path = w.path;
+                task.player = w.player;
+                task.g = g + 1;
+                shared.pending.fetch_add(1, std::memory_order_relaxed);
+                {
+                    std::lock_guard<std::mutex> lock(w.taskMutex);
+                    w.tasks.push_back(std::move(task));
+                }
+                shared.queued.fetch_add(1, std::memory_order_release);
+                shared.wakeIdle(false);
+            }
+        }
+
+        // --- Unmake ---
+        w.path.pop_back();
+        w.player = savedPlayer;
+        w.heuristic = savedHeuristic;
+        if (consumed) {
+            w.boxes.push_back(last);
+        } else {
+            w.boxAt.reset(to);
+            w.boxHash ^= boxKeys[static_cast<std::size_t>(to)];
+        }
+        w.boxes[i] = from;
+        w.boxAt.set(from);
+        w.boxHash ^= boxKeys[static_cast<std::size_t>(from)];
+
+        if (shared.stop.load(std::memory_order_relaxed)) return false;
+    }
+    return false;
+}
+
+// Replays the pushes from the start, adding the shortest walk before each one
+std::string Solver::toLurd(const std::vector<std::pair<int, int>>& pushes) const {
+    std::vector<std::uint8_t> occupied(walls.size(), 0);
+    for (int b : startBoxes) occupied[static_cast<std::size_t>(b)] = 1;
+    std::vector<int> cameFrom(walls.size(), -1); // direction used to enter each cell
+    std::vector<int> frontier;
+    std::string out;
+    int at = startPlayer;
+
+    for (const std::pair<int, int>& push : pushes) {
+        const int from = push.first;
+        const int dir = push.second;
+        const int target = from - offsets[dir];
+
+        std::fill(cameFrom.begin(), cameFrom.end(), -1);
+        frontier.assign(1, at);
+        cameFrom[static_cast<std::size_t>(at)] = 4;
+        for (std::size_t head = 0; head < frontier.size() && cameFrom[static_cast<std::size_t>(target)] < 0; ++head) {
+            const int c = frontier[head];
+            for (int d = 0; d < 4; ++d) {
+                const std::size_t n = static_cast<std::size_t>(c + offsets[d]);
+                if (walls[n] || occupied[n] || cameFrom[n] >= 0) continue;
+                cameFrom[n] = d;
+                frontier.push_back(c + offsets[d]);
+            }
+        }
+        std::string walk;
+        for (int c = target; c != at; c -= offsets[cameFrom[static_cast<std::size_t>(c)]]) {
+            walk += kWalkChar[cameFrom[static_cast<std::size_t>(c)]];
+        }
+        out.append(walk.rbegin(), walk.rend());
+        out += kPushChar[dir];
+
+        const int to = from + offsets[dir];
+        occupied[static_cast<std::size_t>(from)] = 0;
+        if (!consumes(to)) occupied[static_cast<std::size_t>(to)] = 1;
+        at = from;
+    }
+    return out;
+}
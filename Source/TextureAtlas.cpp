@@ -0,0 +1,136 @@
+// TextureAtlas.cpp
+#include "../include/TextureAtlas.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace {
+struct SourceInfo {
+    const char* name;
+    const char* file;     // nullptr => generated
+    bool required;        // the game refuses to start without it
+    sf::Color fallback;   // used when an optional image cannot be decoded
+};
+
+// Indexed by AtlasImage
+const SourceInfo kSources[kAtlasImageCount] = {
+    { "Box",        "Box.jpg",        true,  sf::Color(160, 110, 60) },
+    { "SpecialBox", "SpecialBox.jpg", true,  sf::Color(90, 90, 90) },
+    { "Portal",     "portal.jpg",     false, sf::Color(255, 105, 180) }, // hot pink fallback
+    { "Player1",    "Player1.jpg",    true,  sf::Color::Red },
+    { "Player2",    "Player2.jpg",    true,  sf::Color::Blue },
+    { "Wall",       "Wall.jpg",       false, sf::Color(120, 80, 60) },
+    { "SnowWall",   "SnowWall.jpg",   false, sf::Color(230, 240, 250) },
+    { "Bomb",       "bomb.jpg",       false, sf::Color(30, 30, 30) },
+    { "White",      nullptr,          false, sf::Color::White },
+};
+
+// Box-filter src into the cell at (ox, oy) of dst
+void resampleInto(sf::Image& dst, unsigned ox, unsigned oy, unsigned cell, const sf::Image& src) {
+    const sf::Vector2u ss = src.getSize();
+    const std::uint8_t* pixels = src.getPixelsPtr(); // RGBA, row-major
+    for (unsigned y = 0; y < cell; ++y) {
+        unsigned sy0 = y * ss.y / cell;
+        unsigned sy1 = std::max(sy0 + 1, (y + 1) * ss.y / cell);
+        for (unsigned x = 0; x < cell; ++x) {
+            unsigned sx0 = x * ss.x / cell;
+            unsigned sx1 = std::max(sx0 + 1, (x + 1) * ss.x / cell);
+            unsigned r = 0, g = 0, b = 0, a = 0, n = 0;
+            for (unsigned sy = sy0; sy < sy1; ++sy) {
+                const std::uint8_t* p = pixels + (static_cast<std::size_t>(sy) * ss.x + sx0) * 4;
+                for (unsigned sx = sx0; sx < sx1; ++sx, p += 4) {
+                    r += p[0]; g += p[1]; b += p[2]; a += p[3]; ++n;
+                }
+            }
+            dst.setPixel({ox + x, oy + y}, sf::Color(static_cast<std::uint8_t>(r / n), static_cast<std::uint8_t>(g / n),
+                                                     static_cast<std::uint8_t>(b / n), static_cast<std::uint8_t>(a / n)));
+        }
+    }
+}
+
+void fillCell(sf::Image& dst, unsigned ox, unsigned oy, unsigned cell, sf::Color color) {
+    for (unsigned y = 0; y < cell; ++y)
+        for (unsigned x = 0; x < cell; ++x) dst.setPixel({ox + x, oy + y}, color);
+}
+} // namespace
+
+const char* TextureAtlas::name(AtlasImage id) {
+    return kSources[static_cast<std::size_t>(id)].name;
+}
+
+bool TextureAtlas::pack(const std::string& assetDir) {
+    // Equal-size cells pack perfectly into a near-square grid
+    unsigned cols = 1;
+    while (cols * cols < static_cast<unsigned>(kAtlasImageCount)) ++cols;
+    unsigned rows = (kAtlasImageCount + cols - 1) / cols;
+    atlas.resize({cols * kCellSize, rows * kCellSize}, sf::Color::Transparent);
+
+    bool ok = true;
+    for (int i = 0; i < kAtlasImageCount; ++i) {
+        const SourceInfo& info = kSources[i];
+        const unsigned ox = (i % cols) * kCellSize;
+        const unsigned oy = (i / cols) * kCellSize;
+        rects[static_cast<std::size_t>(i)] = sf::IntRect({static_cast<int>(ox), static_cast<int>(oy)},
+                                                         {static_cast<int>(kCellSize), static_cast<int>(kCellSize)});
+
+        sf::Image src;
+        if (info.file && src.loadFromFile(assetDir + "/" + info.file)) {
+            resampleInto(atlas, ox, oy, kCellSize, src);
+            continue;
+        }
+        if (info.file) {
+            std::cerr << "Failed to load " << assetDir << "/" << info.file
+                      << (info.required ? "\n" : ", using fallback color\n");
+            if (info.required) ok = false;
+        }
+        fillCell(atlas, ox, oy, kCellSize, info.fallback);
+    }
+    return ok;
+}
+
+bool TextureAtlas::savePacked(const std::string& imagePath, const std::string& tablePath) const {
+    if (!atlas.saveToFile(imagePath)) return false;
+    std::ofstream out(tablePath);
+    if (!out) return false;
+    for (int i = 0; i < kAtlasImageCount; ++i) {
+        const sf::IntRect& r = rects[static_cast<std::size_t>(i)];
+        out << kSources[i].name << ' ' << r.position.x << ' ' << r.position.y << ' '
+            << r.size.x << ' ' << r.size.y << '\n';
+    }
+    return static_cast<bool>(out);
+}
+
+bool TextureAtlas::loadPacked(const std::string& imagePath, const std::string& tablePath) {
+    std::ifstream in(tablePath);
+    if (!in) return false;
+
+    std::array<bool, kAtlasImageCount> seen{};
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream ls(line);
+        std::string name;
+        sf::IntRect r;
+        if (!(ls >> name >> r.position.x >> r.position.y >> r.size.x >> r.size.y)) continue;
+        for (int i = 0; i < kAtlasImageCount; ++i) {
+            if (name == kSources[i].name) {
+                rects[static_cast<std::size_t>(i)] = r;
+                seen[static_cast<std::size_t>(i)] = true;
+            }
+        }
+    }
+    for (bool s : seen) {
+        if (!s) return false; // stale table from an older build: repack instead
+    }
+    return atlas.loadFromFile(imagePath);
+}
+
+bool TextureAtlas::loadOrPack(const std::string& assetDir) {
+    if (loadPacked(assetDir + "/" + kPackedAtlasImage, assetDir + "/" + kPackedAtlasTable)) return true;
+    return pack(assetDir);
+}
+
+bool TextureAtlas::upload() {
+    return tex.loadFromImage(atlas);
+}
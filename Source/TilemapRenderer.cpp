@@ -0,0 +1,172 @@
+// TilemapRenderer.cpp
+#include "../include/TilemapRenderer.hpp"
+#include "../include/Trace.hpp"
+
+namespace {
+constexpr std::size_t kVertsPerCell = 6;
+
+// Write a quad as two triangles covering texRect of the atlas
+void writeQuad(sf::Vertex* v, sf::Vector2f pos, float size, const sf::IntRect& texRect, sf::Color color) {
+    const sf::Vector2f tl = pos;
+    const sf::Vector2f tr = pos + sf::Vector2f(size, 0.f);
+    const sf::Vector2f bl = pos + sf::Vector2f(0.f, size);
+    const sf::Vector2f br = pos + sf::Vector2f(size, size);
+
+    const sf::Vector2f uvTL(texRect.position);
+    const sf::Vector2f uvBR(texRect.position + texRect.size);
+    const sf::Vector2f uvTR(uvBR.x, uvTL.y);
+    const sf::Vector2f uvBL(uvTL.x, uvBR.y);
+
+    v[0] = sf::Vertex{tl, color, uvTL};
+    v[1] = sf::Vertex{tr, color, uvTR};
+    v[2] = sf::Vertex{bl, color, uvBL};
+    v[3] = sf::Vertex{bl, color, uvBL};
+    v[4] = sf::Vertex{tr, color, uvTR};
+    v[5] = sf::Vertex{br, color, uvBR};
+}
+} // namespace
+
+TilemapRenderer::TilemapRenderer(float tileSize, const sf::Texture& atlas)
+: tile(tileSize)
+, texture(&atlas)
+, floorDark(220, 226, 234)
+, floorLight(240, 244, 248)
+{
+}
+
+void TilemapRenderer::setStyle(TileType kind, const sf::IntRect& texRect, float size, const sf::Color& color) {
+    Style& style = styles[static_cast<std::size_t>(kind)];
+    style.texRect = texRect;
+    style.size = size;
+    style.color = color;
+    builtVersion = ~0ull; // force a rebuild on the next sync
+}
+
+void TilemapRenderer::setFloorColors(const sf::Color& dark, const sf::Color& light) {
+    floorDark = dark;
+    floorLight = light;
+    builtVersion = ~0ull;
+}
+
+void TilemapRenderer::sync(const World& world) {
+    TRACE_SCOPE("TilemapRenderer::sync");
+    if (world.layoutVersion() != builtVersion || world.width() != width || world.height() != height) {
+        rebuild(world);
+        return;
+    }
+    const TileType* cells = world.tileData();
+    for (int cell : world.changedCells()) {
+        const int mapCell = world.cellY(cell) * width + world.cellX(cell); // drop the world's border
+        if (shown[static_cast<std::size_t>(mapCell)] != cells[cell]) writeCell(mapCell, cells[cell]);
+    }
+}
+
+void TilemapRenderer::rebuild(const World& world) {
+    TRACE_SCOPE("TilemapRenderer::rebuild");
+    width = world.width();
+    height = world.height();
+    const std::size_t count = static_cast<std::size_t>(width * height);
+
+    buildFloor();
+
+    entityVertices.clear();
+    entityCell.clear();
+    entitySlot.assign(count, -1);
+    shown.assign(count, TileType::Floor);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            const TileType kind = world.tileAt(x, y);
+            if (kind != TileType::Floor) writeCell(y * width + x, kind);
+        }
+    }
+    builtVersion = world.layoutVersion();
+}
+
+void TilemapRenderer::buildFloor() {
+    const Style& style = styles[static_cast<std::size_t>(TileType::Floor)];
+    floorVertices.resize(static_cast<std::size_t>(width * height) * kVertsPerCell);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            bool dark = ((x + y) % 2) == 0;
+            std::size_t cell = static_cast<std::size_t>(y * width + x);
+            writeQuad(&floorVertices[cell * kVertsPerCell], sf::Vector2f(x * tile, y * tile), style.size,
+                      style.texRect, dark ? floorDark : floorLight);
+        }
+    }
+
+    // Render the floor once into the cache; very large maps exceed the GPU's
+    // texture size limit, in which case the floor vertices are drawn directly
+    floorSprite.reset();
+    const sf::Vector2u size(static_cast<unsigned>(width * tile), static_cast<unsigned>(height * tile));
+    if (size.x <= sf::Texture::getMaximumSize() && size.y <= sf::Texture::getMaximumSize()
+        && floorCache.resize(size)) {
+        sf::RenderStates states;
+        states.texture = texture;
+        TRACE_SCOPE("floor cache render");
+        floorCache.clear(sf::Color::Black);
+        floorCache.draw(floorVertices.data(), floorVertices.size(), sf::PrimitiveType::Triangles, states);
+        floorCache.display();
+        floorSprite.emplace(floorCache.getTexture());
+        ++cacheBuilds;
+    }
+}
+
+void TilemapRenderer::writeCell(int cell, TileType kind) {
+    const std::size_t c = static_cast<std::size_t>(cell);
+    shown[c] = kind;
+    if (kind == TileType::Floor) {
+        removeEntity(cell); // the cached floor shows through
+        return;
+    }
+
+    int slot = entitySlot[c];
+    if (slot < 0) {
+        slot = static_cast<int>(entityCell.size());
+        entitySlot[c] = slot;
+        entityCell.push_back(cell);
+        entityVertices.resize(entityVertices.size() + kVertsPerCell);
+    }
+
+    const Style& style = styles[static_cast<std::size_t>(kind)];
+    const sf::Vector2f pos((cell % width) * tile, (cell / width) * tile);
+    writeQuad(&entityVertices[static_cast<std::size_t>(slot) * kVertsPerCell], pos, style.size,
+              style.texRect, style.color);
+}
+
+void TilemapRenderer::removeEntity(int cell) {
+    const int slot = entitySlot[static_cast<std::size_t>(cell)];
+    if (slot < 0) return;
+
+    // swap-remove: move the last quad into the vacated slot
+    const int lastSlot = static_cast<int>(entityCell.size()) - 1;
+    const int lastCell = entityCell[static_cast<std::size_t>(lastSlot)];
+    if (slot != lastSlot) {
+        for (std::size_t i = 0; i < kVertsPerCell; ++i) {
+            entityVertices[static_cast<std::size_t>(slot) * kVertsPerCell + i] =
+                entityVertices[static_cast<std::size_t>(lastSlot) * kVertsPerCell + i];
+        }
+        entityCell[static_cast<std::size_t>(slot)] = lastCell;
+        entitySlot[static_cast<std::size_t>(lastCell)] = slot;
+    }
+    entityCell.pop_back();
+    entityVertices.resize(entityVertices.size() - kVertsPerCell);
+    entitySlot[static_cast<std::size_t>(cell)] = -1;
+}
+
+void TilemapRenderer::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+    lastDrawCalls = 0;
+    if (floorSprite) {
+        target.draw(*floorSprite, states);
+    } else {
+        sf::RenderStates floorStates = states;
+        floorStates.texture = texture;
+        target.draw(floorVertices.data(), floorVertices.size(), sf::PrimitiveType::Triangles, floorStates);
+    }
+    ++lastDrawCalls;
+
+    if (!entityVertices.empty()) {
+        states.texture = texture;
+        target.draw(entityVertices.data(), entityVertices.size(), sf::PrimitiveType::Triangles, states);
+        ++lastDrawCalls;
+    }
+}
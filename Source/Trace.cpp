@@ -0,0 +1,161 @@
+// Trace.cpp
+#include "../include/Trace.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace trace {
+
+namespace {
+
+// One ring slot; fields are relaxed atomics so flush() may read a slot the owner
+// is rewriting (it then discards the copy) without a data race
+struct Slot {
+    std::atomic<const char*> name{ nullptr };
+    std::atomic<std::uint64_t> startNs{ 0 };
+    std::atomic<std::uint64_t> durationNs{ 0 };
+    std::atomic<std::int64_t> value{ 0 };
+    std::atomic<EventType> type{ EventType::Instant };
+};
+
+// One ring per thread. Only the owning thread writes. 'started' is bumped before
+// a slot is rewritten and 'written' publishes it (release/acquire), so flush()
+// can tell which of the slots it copied may have changed under it.
+struct ThreadBuffer {
+    Slot events[kEventsPerThread];
+    std::atomic<std::uint64_t> started{ 0 };
+    std::atomic<std::uint64_t> written{ 0 };
+    int tid = 0;
+    char name[32] = {};
+};
+
+// Registry slots are claimed with one fetch_add; a buffer lives until process exit
+// so flush() stays valid after its thread has finished
+std::atomic<ThreadBuffer*> buffers[kMaxThreads];
+std::atomic<int> bufferCount{ 0 };
+
+thread_local ThreadBuffer* localBuffer = nullptr;
+thread_local bool registryFull = false;
+
+// The name is fixed before the buffer is published, so flush() never reads it mid-write
+ThreadBuffer* threadBuffer(const char* name = nullptr) {
+    if (localBuffer || registryFull) return localBuffer;
+
+    const int slot = bufferCount.fetch_add(1, std::memory_order_relaxed);
+    if (slot >= kMaxThreads) {
+        registryFull = true; // further threads are not traced
+        return nullptr;
+    }
+    localBuffer = new ThreadBuffer();
+    localBuffer->tid = slot + 1;
+    if (name) std::strncpy(localBuffer->name, name, sizeof(localBuffer->name) - 1);
+    else std::snprintf(localBuffer->name, sizeof(localBuffer->name), "thread %d", slot + 1);
+    buffers[slot].store(localBuffer, std::memory_order_release);
+    return localBuffer;
+}
+
+// Event names are literals from our own code, but keep the JSON valid regardless
+void writeJsonString(std::FILE* out, const char* s) {
+    std::fputc('"', out);
+    for (; *s; ++s) {
+        if (*s == '"' || *s == '\\') std::fputc('\\', out);
+        if (static_cast<unsigned char>(*s) >= 0x20) std::fputc(*s, out);
+    }
+    std::fputc('"', out);
+}
+
+} // namespace
+
+namespace detail {
+std::atomic<bool> enabledFlag{ false };
+std::atomic<std::chrono::steady_clock::rep> epochTicks{ std::chrono::steady_clock::now().time_since_epoch().count() };
+
+void record(const Event& ev) {
+    ThreadBuffer* buf = threadBuffer();
+    if (!buf) return;
+    const std::uint64_t n = buf->written.load(std::memory_order_relaxed);
+    buf->started.store(n + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release); // 'started' is visible before any field below
+    Slot& slot = buf->events[n % kEventsPerThread];
+    slot.name.store(ev.name, std::memory_order_relaxed);
+    slot.startNs.store(ev.startNs, std::memory_order_relaxed);
+    slot.durationNs.store(ev.durationNs, std::memory_order_relaxed);
+    slot.value.store(ev.value, std::memory_order_relaxed);
+    slot.type.store(ev.type, std::memory_order_relaxed);
+    buf->written.store(n + 1, std::memory_order_release);
+}
+} // namespace detail
+
+void start() {
+    if (enabled()) return;
+    detail::epochTicks.store(std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+    detail::enabledFlag.store(true, std::memory_order_release);
+}
+
+void stop() {
+    detail::enabledFlag.store(false, std::memory_order_release);
+}
+
+void setThreadName(const char* name) {
+    threadBuffer(name);
+}
+
+bool flush(const char* path) {
+    std::FILE* out = std::fopen(path, "w");
+    if (!out) return false;
+
+    std::fprintf(out, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    bool first = true;
+    std::vector<Event> copied;
+    const int count = bufferCount.load(std::memory_order_relaxed);
+    for (int i = 0; i < count && i < kMaxThreads; ++i) {
+        const ThreadBuffer* buf = buffers[i].load(std::memory_order_acquire);
+        if (!buf) continue; // slot claimed, buffer not published yet
+
+        std::fprintf(out, "%s{\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"name\":\"thread_name\",\"args\":{\"name\":",
+                     first ? "" : ",\n", buf->tid);
+        writeJsonString(out, buf->name);
+        std::fprintf(out, "}}");
+        first = false;
+
+        // The owner may keep writing while we copy. Every slot it touched since
+        // 'end' was read belongs to an event counted in 'started' afterwards
+        // (release fence in record(), acquire fence here), so slots that such
+        // an event reuses are dropped from the copy.
+        const std::uint64_t end = buf->written.load(std::memory_order_acquire);
+        const std::uint64_t copyBegin = end > kEventsPerThread ? end - kEventsPerThread : 0;
+        copied.clear();
+        for (std::uint64_t n = copyBegin; n < end; ++n) {
+            const Slot& slot = buf->events[n % kEventsPerThread];
+            copied.push_back({ slot.name.load(std::memory_order_relaxed), slot.startNs.load(std::memory_order_relaxed),
+                               slot.durationNs.load(std::memory_order_relaxed), slot.value.load(std::memory_order_relaxed),
+                               slot.type.load(std::memory_order_relaxed) });
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const std::uint64_t started = buf->started.load(std::memory_order_relaxed);
+        const std::uint64_t begin = started > kEventsPerThread ? std::max(copyBegin, started - kEventsPerThread) : copyBegin;
+
+        for (std::uint64_t n = begin; n < end; ++n) {
+            const Event& ev = copied[static_cast<std::size_t>(n - copyBegin)];
+            std::fprintf(out, ",\n{\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"name\":", buf->tid, ev.startNs / 1000.0);
+            writeJsonString(out, ev.name);
+            switch (ev.type) {
+                case EventType::Complete:
+                    std::fprintf(out, ",\"ph\":\"X\",\"dur\":%.3f}", ev.durationNs / 1000.0);
+                    break;
+                case EventType::Instant:
+                    std::fprintf(out, ",\"ph\":\"i\",\"s\":\"t\"}");
+                    break;
+                case EventType::Counter:
+                    std::fprintf(out, ",\"ph\":\"C\",\"args\":{\"value\":%lld}}", static_cast<long long>(ev.value));
+                    break;
+            }
+        }
+    }
+    std::fprintf(out, "\n]}\n");
+    return std::fclose(out) == 0;
+}
+
+} // namespace trace
@@ -0,0 +1,218 @@
+// VecWorld.cpp
+#include "../include/VecWorld.hpp"
+#include "../include/Trace.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+// MoveDir -> one step; anything out of range stays put
+PlayerInput stepOf(std::uint8_t action) {
+    static constexpr PlayerInput kSteps[] = { { 0, 0 }, { 0, -1 }, { 0, 1 }, { -1, 0 }, { 1, 0 } };
+    return action < 5 ? kSteps[action] : PlayerInput();
+}
+
+} // namespace
+
+// Workers wait for a new generation, step their slice, and report back; the
+// calling thread steps slice 0 itself
+template <class Board>
+struct BasicVecWorld<Board>::Pool {
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    std::uint64_t generation = 0;
+    int running = 0;
+    bool stopping = false;
+};
+
+template <class Board>
+BasicVecWorld<Board>::BasicVecWorld(int count, const WorldConfig& config, int threads)
+: count(std::max(1, count))
+, threads(threads > 0 ? threads : static_cast<int>(std::thread::hardware_concurrency()))
+{
+    this->threads = std::max(1, std::min(this->threads, this->count));
+    const std::size_t n = static_cast<std::size_t>(this->count);
+
+    worlds.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        WorldConfig c = config;
+        c.seed = config.seed + i;
+        worlds.emplace_back(c);
+    }
+    episodes.assign(n, 0);
+
+    obsStride = static_cast<std::size_t>(kPlanes * width() * height());
+    actionBuf.assign(n * 2, static_cast<std::uint8_t>(MoveDir::None));
+    obsBuf.assign(n * obsStride, 0);
+    rewardBuf.assign(n * 2, 0.0f);
+    doneBuf.assign(n, 0);
+    shown.assign(n, Shown());
+    for (int m = 0; m < this->count; ++m) {
+        writeObservation(m);
+        worlds[static_cast<std::size_t>(m)].clearChangedCells();
+    }
+
+    if (this->threads > 1) {
+        pool = std::make_unique<Pool>();
+        for (int i = 1; i < this->threads; ++i) pool->workers.emplace_back(&BasicVecWorld::runWorker, this, i);
+    }
+}
+
+template <class Board>
+BasicVecWorld<Board>::~BasicVecWorld() {
+    if (!pool) return;
+    {
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        pool->stopping = true;
+    }
+    pool->wake.notify_all();
+    for (std::thread& t : pool->workers) t.join();
+}
+
+template <class Board>
+void BasicVecWorld<Board>::reset() {
+    for (int m = 0; m < count; ++m) {
+        const std::size_t i = static_cast<std::size_t>(m);
+        episodes[i] = 0;
+        worlds[i].restart(0);
+        writeObservation(m);
+        worlds[i].clearChangedCells();
+    }
+    std::fill(rewardBuf.begin(), rewardBuf.end(), 0.0f);
+    std::fill(doneBuf.begin(), doneBuf.end(), 0);
+}
+
+template <class Board>
+void BasicVecWorld<Board>::step() {
+    TRACE_SCOPE("VecWorld::step");
+    if (!pool) {
+        stepRange(0, count);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        ++pool->generation;
+        pool->running = threads - 1;
+    }
+    pool->wake.notify_all();
+    stepRange(0, count / threads);
+    std::unique_lock<std::mutex> lock(pool->mutex);
+    pool->finished.wait(lock, [this] { return pool->running == 0; });
+}
+
+template <class Board>
+void BasicVecWorld<Board>::runWorker(int index) {
+    std::uint64_t seen = 0;
+    const int begin = static_cast<int>(static_cast<long long>(count) * index / threads);
+    const int end = static_cast<int>(static_cast<long long>(count) * (index + 1) / threads);
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(pool->mutex);
+            pool->wake.wait(lock, [&] { return pool->stopping || pool->generation != seen; });
+            if (pool->stopping) return;
+            seen = pool->generation;
+        }
+        stepRange(begin, end);
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        if (--pool->running == 0) pool->finished.notify_one();
+    }
+}
+
+template <class Board>
+void BasicVecWorld<Board>::stepRange(int begin, int end) {
+    // Rewards and done flags pack many matches per cache line, and the line at a
+    // slice boundary belongs to two threads. They are gathered on the stack and
+    // copied out once per chunk, so those lines are not bounced per match.
+    constexpr int kChunk = 64;
+    float rewards[kChunk * 2];
+    std::uint8_t dones[kChunk];
+
+    for (int first = begin; first < end; first += kChunk) {
+        const int last = std::min(end, first + kChunk);
+        for (int m = first; m < last; ++m) {
+            const std::size_t i = static_cast<std::size_t>(m);
+            const std::size_t k = static_cast<std::size_t>(m - first);
+            BasicWorld<Board>& w = worlds[i];
+
+            Inputs in;
+            in.player[0] = stepOf(actionBuf[i * 2]);
+            in.player[1] = stepOf(actionBuf[i * 2 + 1]);
+            const int before[2] = { w.player(0).score, w.player(1).score };
+            w.step(in);
+            rewards[k * 2] = static_cast<float>(w.player(0).score - before[0]);
+            rewards[k * 2 + 1] = static_cast<float>(w.player(1).score - before[1]);
+
+            // Every (match, episode) pair gets its own stream, forked from the
+            // match's expanded seed: a restart pays for reset(), never for jumps
+            const bool done = w.isGameOver();
+            dones[k] = done ? 1 : 0;
+            if (done) w.restart(++episodes[i]);
+
+            if (w.layoutVersion() != shown[i].layout) writeObservation(m);
+            else updateObservation(m);
+            w.clearChangedCells();
+        }
+        const std::size_t n = static_cast<std::size_t>(last - first);
+        std::copy(rewards, rewards + n * 2, rewardBuf.begin() + static_cast<std::ptrdiff_t>(first) * 2);
+        std::copy(dones, dones + n, doneBuf.begin() + first);
+    }
+}
+
+template <class Board>
+void BasicVecWorld<Board>::writeObservation(int match) {
+    const std::size_t i = static_cast<std::size_t>(match);
+    const BasicWorld<Board>& w = worlds[i];
+    const int cells = w.width() * w.height();
+    std::uint8_t* obs = obsBuf.data() + i * obsStride;
+    std::fill(obs, obs + obsStride, 0);
+    for (int y = 0; y < w.height(); ++y) {
+        for (int x = 0; x < w.width(); ++x) {
+            const int cell = y * w.width() + x;
+            switch (w.tileAt(x, y)) {
+                case TileType::Box:         obs[kPlaneWalls * cells + cell] = 1; break;
+                case TileType::PushableBox: obs[kPlaneBoxes * cells + cell] = 1; break;
+                case TileType::Portal:      obs[kPlanePortals * cells + cell] = 1; break;
+                default: break;
+            }
+        }
+    }
+    for (int p = 0; p < 2; ++p) {
+        const int cell = w.player(p).y * w.width() + w.player(p).x;
+        obs[(kPlanePlayer1 + p) * cells + cell] = 1;
+        shown[i].playerCell[p] = cell;
+    }
+    shown[i].layout = w.layoutVersion();
+}
+
+template <class Board>
+void BasicVecWorld<Board>::updateObservation(int match) {
+    const std::size_t i = static_cast<std::size_t>(match);
+    const BasicWorld<Board>& w = worlds[i];
+    const int cells = w.width() * w.height();
+    std::uint8_t* obs = obsBuf.data() + i * obsStride;
+    const TileType* tiles = w.tileData();
+    for (int changedCell : w.changedCells()) {
+        const int cell = w.cellY(changedCell) * w.width() + w.cellX(changedCell);
+        const TileType kind = tiles[changedCell];
+        obs[kPlaneWalls * cells + cell] = kind == TileType::Box;
+        obs[kPlaneBoxes * cells + cell] = kind == TileType::PushableBox;
+        obs[kPlanePortals * cells + cell] = kind == TileType::Portal;
+    }
+    for (int p = 0; p < 2; ++p) {
+        int& shownCell = shown[i].playerCell[p];
+        const int cell = w.player(p).y * w.width() + w.player(p).x;
+        if (cell == shownCell) continue;
+        std::uint8_t* plane = obs + (kPlanePlayer1 + p) * cells;
+        plane[shownCell] = 0;
+        plane[cell] = 1;
+        shownCell = cell;
+    }
+}
+
+template class BasicVecWorld<DynamicBoard>;
+template class BasicVecWorld<FixedBoard<32, 18>>;
@@ -0,0 +1,419 @@
+// World.cpp
+#include "../include/World.hpp"
+#include "../include/Trace.hpp"
+
+#include <algorithm>
+
+namespace {
+
+// --- Zobrist keys: one mixed value per (domain, index), nothing stored ---
+// A key table would cost 48 bytes per cell; mixing the index costs a few
+// multiplies and gives every world of a size the same keys.
+// Player and score keys take one domain per player (kPlayerKeys + index)
+enum KeyDomain : std::uint64_t { kTileKeys = 1, kPlayerKeys = 3, kScoreKeys = 5, kRngKeys = 7 };
+
+std::uint64_t keyOf(std::uint64_t domain, std::uint64_t index) {
+    return mix64((domain << 56) ^ index);
+}
+
+// Floor is the background and hashes to nothing
+std::uint64_t tileKey(int cell, TileType t) {
+    if (t == TileType::Floor) return 0;
+    return keyOf(kTileKeys, static_cast<std::uint64_t>(cell) * kTileTypeCount + static_cast<std::uint64_t>(t));
+}
+
+std::uint64_t playerKey(int playerIndex, int cell) {
+    return keyOf(kPlayerKeys + static_cast<std::uint64_t>(playerIndex), static_cast<std::uint64_t>(cell));
+}
+
+std::uint64_t scoreKey(int playerIndex, int score) {
+    return keyOf(kScoreKeys + static_cast<std::uint64_t>(playerIndex), static_cast<std::uint32_t>(score));
+}
+
+std::uint64_t rngKey(const Rng& rng) {
+    const std::uint64_t* s = rng.state();
+    return keyOf(kRngKeys, s[0] ^ mix64(s[1] ^ mix64(s[2] ^ mix64(s[3]))));
+}
+
+} // namespace
+
+template <class Board>
+BasicWorld<Board>::BasicWorld(const WorldConfig& config)
+: config(config)
+{
+    // A fixed board owns its size; the config reports what is actually simulated
+    this->config.width = width();
+    this->config.height = height();
+    seedRng.reseed(config.seed, config.stream);
+    startRng = seedRng;
+    const std::size_t cells = static_cast<std::size_t>(stride() * (height() + 2));
+    const std::size_t mapCells = static_cast<std::size_t>(width() * height());
+    tiles.assign(cells, TileType::Box); // the ring keeps this; reset() clears the map
+    freeSlot.assign(cells, -1);
+    board.assign(cells, 0);
+    changedFlag.assign(cells, 0);
+    boxes.resize(static_cast<int>(cells));
+    frozen.resize(static_cast<int>(cells));
+    freeCells.reserve(mapCells);
+    changed.reserve(mapCells);
+    reset();
+}
+
+template <class Board>
+void BasicWorld<Board>::reset() {
+    const int w = width();
+    const int h = height();
+
+    // --- Initialize map with plain floor tiles (inside the sentinel ring) ---
+    for (int y = 0; y < h; ++y) {
+        TileType* row = &tiles[cellAt(0, y)];
+        std::fill(row, row + w, TileType::Floor);
+    }
+
+    // --- Place an immovable special box at center (example) ---
+    const int centerX = w / 2;
+    const int centerY = h / 2;
+    tiles[cellAt(centerX, centerY)] = TileType::Box;
+
+    // --- Place a couple of pushable boxes (player can push these) ---
+    tiles[cellAt(centerX + 1, centerY)] = TileType::PushableBox;
+    tiles[cellAt(centerX - 2, centerY)] = TileType::PushableBox;
+
+    // --- Place a portal for testing ---
+    tiles[cellAt(centerX + 3, centerY + 2)] = TileType::Portal;
+
+    // --- Players: P1 on the left quarter, P2 on the right quarter ---
+    players[0] = PlayerState();
+    players[0].x = w / 4;
+    players[0].y = h / 2;
+    players[1] = PlayerState();
+    players[1].x = (w * 3) / 4;
+    players[1].y = h / 2;
+    cancelled[0] = cancelled[1] = false;
+
+    clearChangedCells();
+    ++layoutGen;
+
+    rng = startRng; // no stream jumps per restart
+    tickCount = 0;
+    lastSpawnTick = 0;
+    gameOver = false;
+
+    rebuildDeadlocks();
+    hash = computeStateHash();
+}
+
+template <class Board>
+void BasicWorld<Board>::reseed(std::uint64_t seed) {
+    config.seed = seed;
+    seedRng.reseed(seed, config.stream);
+    startRng = seedRng;
+    reset();
+}
+
+template <class Board>
+void BasicWorld<Board>::restart(std::uint64_t episode) {
+    startRng = seedRng.fork(episode);
+    reset();
+}
+
+template <class Board>
+void BasicWorld<Board>::setTileAt(int x, int y, TileType t) {
+    const int cell = cellAt(x, y);
+    const TileType old = tiles[cell];
+    if (old == t) return; // nothing to rehash or rebuild
+    setTile(cell, t);
+
+    // Walls and portals change the dead squares; boxes only the frozen set
+    auto isStatic = [](TileType k) { return k == TileType::Box || k == TileType::Portal; };
+    if (isStatic(old) || isStatic(t)) {
+        rebuildDeadlocks();
+    } else {
+        refreshFrozenAround(cell);
+        refreshFreeCell(cell);
+    }
+}
+
+template <class Board>
+void BasicWorld<Board>::placePlayer(int index, int x, int y) {
+    PlayerState& p = players[index];
+    const int fromCell = cellAt(p.x, p.y);
+    p.x = x;
+    p.y = y;
+    hash ^= playerKey(index, fromCell) ^ playerKey(index, cellAt(x, y));
+    refreshFreeCell(fromCell);
+    refreshFreeCell(cellAt(x, y));
+}
+
+template <class Board>
+void BasicWorld<Board>::clearChangedCells() {
+    for (int cell : changed) changedFlag[cell] = 0;
+    changed.clear();
+}
+
+template <class Board>
+void BasicWorld<Board>::setTile(int cell, TileType t) {
+    hash ^= tileKey(cell, tiles[cell]) ^ tileKey(cell, t);
+    tiles[cell] = t;
+    boxes.assign(cell, t == TileType::PushableBox); // 'frozen' follows in refreshFrozenAround()
+    if (!changedFlag[cell]) {
+        changedFlag[cell] = 1;
+        changed.push_back(cell); // capacity reserved up front
+    }
+}
+
+template <class Board>
+bool BasicWorld<Board>::isPlayerAt(int cell) const {
+    return cell == cellAt(players[0].x, players[0].y) || cell == cellAt(players[1].x, players[1].y);
+}
+
+// Re-evaluate one cell after its tile or occupancy changed
+template <class Board>
+void BasicWorld<Board>::refreshFreeCell(int cell) {
+    bool isFree = tiles[cell] == TileType::Floor && !isPlayerAt(cell)
+                  && !(spawnAvoidsDead && deadlocks.isDead(cell));
+    int slot = freeSlot[cell];
+
+    if (isFree && slot < 0) {
+        freeSlot[cell] = static_cast<int>(freeCells.size());
+        freeCells.push_back(cell); // capacity reserved up front, never reallocates
+    } else if (!isFree && slot >= 0) {
+        // swap-remove: move the last entry into the vacated slot
+        int last = freeCells.back();
+        freeCells[slot] = last;
+        freeSlot[last] = slot;
+        freeCells.pop_back();
+        freeSlot[cell] = -1;
+    }
+}
+
+template <class Board>
+void BasicWorld<Board>::rebuildFreeCells() {
+    freeCells.clear();
+    std::fill(freeSlot.begin(), freeSlot.end(), -1);
+    for (int cell = 0; cell < static_cast<int>(tiles.size()); ++cell) {
+        refreshFreeCell(cell);
+    }
+}
+
+// Static layout changed: recompute dead squares, then every frozen box and the free cells
+template <class Board>
+void BasicWorld<Board>::rebuildDeadlocks() {
+    // Deadlock flags per tile kind: blocking tiles are walls, box-consuming ones goals
+    std::uint8_t flagsOf[kTileTypeCount];
+    for (int k = 0; k < kTileTypeCount; ++k) {
+        const TileTraits& tt = kTileTraits[k];
+        flagsOf[k] = static_cast<std::uint8_t>((!tt.walkable && !tt.pushable ? DeadlockTable::kWall : 0)
+                                               | (tt.consumesBox ? DeadlockTable::kGoal : 0));
+    }
+    const int count = static_cast<int>(tiles.size());
+    const TileType* tile = tiles.data();
+    std::uint8_t* flags = board.data();
+    for (int cell = 0; cell < count; ++cell) flags[cell] = flagsOf[static_cast<int>(tile[cell])];
+    boxes.clear();
+    for (int cell = 0; cell < count; ++cell) {
+        if (tile[cell] == TileType::PushableBox) boxes.set(cell);
+    }
+    deadlocks.build(stride(), height() + 2, board.data()); // the ring reads as wall
+    spawnAvoidsDead = deadlocks.liveCount() > 0;
+
+    // Boxes are sparse after a reset: skip empty 64-cell words
+    frozen.clear();
+    const std::uint64_t* words = boxes.data();
+    for (int base = 0; base < count; base += 64) {
+        if (!words[base / 64]) continue;
+        const int end = std::min(base + 64, count);
+        for (int cell = base; cell < end; ++cell) {
+            if (boxes.test(cell) && deadlocks.isFrozen(boxes, cell, &frozen)) frozen.set(cell);
+        }
+    }
+    rebuildFreeCells();
+}
+
+// Re-test one cell without its own bit, so a stale 'frozen' can't hold itself
+// up through a neighbor; true if the state flipped
+template <class Board>
+bool BasicWorld<Board>::retestFrozen(int cell) {
+    const bool was = frozen.test(cell);
+    frozen.reset(cell);
+    const bool now = boxes.test(cell) && deadlocks.isFrozen(boxes, cell, &frozen);
+    frozen.assign(cell, now);
+    return now != was;
+}
+
+// A box arrived at or left 'cell'. Adding a box can only freeze boxes and
+// removing one can only release them, and only through a box whose own state
+// flipped (one that is not frozen blocks nobody). So the refresh spreads from
+// a flipped box to neighbors that could flip the same way, and on from those.
+template <class Board>
+void BasicWorld<Board>::refreshFrozenAround(int cell) {
+    const bool was = frozen.test(cell);
+    if (retestFrozen(cell)) spreadFrozen(cell, !was);
+}
+
+template <class Board>
+void BasicWorld<Board>::spreadFrozen(int cell, bool freezing) {
+    const int around[4] = { -stride(), stride(), -1, 1 }; // the ring holds no boxes
+    for (int offset : around) {
+        const int n = cell + offset;
+        if (boxes.test(n) && frozen.test(n) != freezing && retestFrozen(n)) spreadFrozen(n, freezing);
+    }
+}
+
+template <class Board>
+std::uint64_t BasicWorld<Board>::computeStateHash() const {
+    std::uint64_t h = rngKey(rng);
+    for (int y = 0; y < height(); ++y) {
+        for (int x = 0; x < width(); ++x) {
+            const int cell = cellAt(x, y);
+            h ^= tileKey(cell, tiles[cell]);
+        }
+    }
+    for (int p = 0; p < 2; ++p) {
+        h ^= playerKey(p, cellAt(players[p].x, players[p].y)) ^ scoreKey(p, players[p].score);
+    }
+    return h;
+}
+
+template <class Board>
+int BasicWorld<Board>::remainingSeconds() const {
+    int elapsed = static_cast<int>(tickCount / static_cast<std::uint64_t>(config.tickRate));
+    int remaining = config.gameDurationSec - elapsed;
+    return remaining < 0 ? 0 : remaining;
+}
+
+template <class Board>
+int BasicWorld<Board>::winner() const {
+    if (players[0].score > players[1].score) return 1;
+    if (players[1].score > players[0].score) return 2;
+    return 0;
+}
+
+template <class Board>
+void BasicWorld<Board>::step(const Inputs& inputs) {
+    cancelled[0] = cancelled[1] = false;
+    if (gameOver) return; // the match is frozen once the timer runs out
+    TRACE_SCOPE("World::step");
+
+    ++tickCount;
+
+    // ---------- Timer update ----------
+    if (remainingSeconds() <= 0) {
+        gameOver = true;
+        return;
+    }
+
+    // ---------- Automatic Box Spawning ----------
+    if (tickCount - lastSpawnTick >= static_cast<std::uint64_t>(config.spawnIntervalTicks)) {
+        ScopedTimer timer(profiler, Phase::Spawn);
+        TRACE_SCOPE("spawn");
+        lastSpawnTick = tickCount;
+        spawnBox();
+    }
+
+    // ---------- Movement ----------
+    ScopedTimer timer(profiler, Phase::Moves);
+
+    // Inputs arrive every tick; a player only steps once its move cooldown has elapsed
+    PlayerInput in1 = inputs.player[0];
+    PlayerInput in2 = inputs.player[1];
+    PlayerState& p1 = players[0];
+    PlayerState& p2 = players[1];
+    if (tickCount < p1.nextMoveTick) in1 = PlayerInput();
+    if (tickCount < p2.nextMoveTick) in2 = PlayerInput();
+    if (in1.dx != 0 || in1.dy != 0) p1.nextMoveTick = tickCount + config.moveIntervalTicks;
+    if (in2.dx != 0 || in2.dy != 0) p2.nextMoveTick = tickCount + config.moveIntervalTicks;
+
+    // Simple simultaneous-move resolution:
+    // - compute intended destinations and avoid allowing both players to move into the same tile
+    int p1_targetX = p1.x + in1.dx, p1_targetY = p1.y + in1.dy;
+    int p2_targetX = p2.x + in2.dx, p2_targetY = p2.y + in2.dy;
+
+    // If both intend to move into same tile, cancel both moves (could also pick priority)
+    bool conflictSameTile = (in1.dx != 0 || in1.dy != 0) && (in2.dx != 0 || in2.dy != 0)
+                            && (p1_targetX == p2_targetX && p1_targetY == p2_targetY);
+
+    // If they intend to swap positions (p1 -> p2 current and p2 -> p1 current) cancel both
+    bool swapPositions = (p1_targetX == p2.x && p1_targetY == p2.y) &&
+                         (p2_targetX == p1.x && p2_targetY == p1.y);
+
+    if (!conflictSameTile && !swapPositions) {
+        // apply both moves (order here matters if boxes involved)
+        tryMovePlayer(0, in1.dx, in1.dy);
+        tryMovePlayer(1, in2.dx, in2.dy);
+    } else {
+        cancelled[0] = in1.dx != 0 || in1.dy != 0;
+        cancelled[1] = in2.dx != 0 || in2.dy != 0;
+    }
+}
+
+template <class Board>
+void BasicWorld<Board>::spawnBox() {
+    if (freeCells.empty()) return; // board is full
+
+    // Pick uniformly among the cells that are floor and not under a player
+    hash ^= rngKey(rng);
+    int cell = freeCells[rng.below(static_cast<std::uint32_t>(freeCells.size()))];
+    hash ^= rngKey(rng);
+    setTile(cell, TileType::PushableBox);
+    refreshFreeCell(cell);
+    refreshFrozenAround(cell);
+}
+
+template <class Board>
+void BasicWorld<Board>::tryMovePlayer(int playerIndex, int dx, int dy) {
+    if (dx == 0 && dy == 0) return; // no movement intended
+
+    PlayerState& self = players[playerIndex];
+    const PlayerState& other = players[1 - playerIndex];
+
+    // One linear offset per direction; a step off the map lands on the Box ring,
+    // which is neither walkable nor pushable, and a box pushed off it is blocked
+    const int offset = dy * stride() + dx;
+    const int fromCell = cellAt(self.x, self.y);
+    const int otherCell = cellAt(other.x, other.y);
+    const int targetCell = fromCell + offset;
+
+    // prevent moving onto the other player's *current* position
+    if (targetCell == otherCell) return;
+
+    const TileTraits& tt = traitsOf(tiles[targetCell]);
+
+    if (tt.walkable) {
+        self.x += dx;
+        self.y += dy;
+        hash ^= playerKey(playerIndex, fromCell) ^ playerKey(playerIndex, targetCell);
+        refreshFreeCell(fromCell);
+        refreshFreeCell(targetCell);
+        return;
+    }
+
+    if (!tt.pushable) return;
+
+    const int boxCell = targetCell + offset;
+    if (boxCell == otherCell) return;
+    const TileTraits& bt = traitsOf(tiles[boxCell]);
+
+    if (bt.boxLandsAs == TileType::Count) return; // blocked
+
+    // The box either moves onto the cell or (portal) disappears into it and scores
+    setTile(boxCell, bt.boxLandsAs);
+    setTile(targetCell, TileType::Floor);
+    if (bt.scoreValue != 0) {
+        hash ^= scoreKey(playerIndex, self.score);
+        self.score += bt.scoreValue;
+        hash ^= scoreKey(playerIndex, self.score);
+    }
+    if (bt.consumesBox) TRACE_INSTANT("portal consume");
+    self.x += dx; // Player moves to where box was
+    self.y += dy;
+    hash ^= playerKey(playerIndex, fromCell) ^ playerKey(playerIndex, targetCell);
+    refreshFreeCell(fromCell);
+    refreshFreeCell(targetCell);
+    refreshFreeCell(boxCell);
+    refreshFrozenAround(targetCell);
+    if (!bt.consumesBox) refreshFrozenAround(boxCell);
+}
+
+template class BasicWorld<DynamicBoard>;
+template class BasicWorld<FixedBoard<32, 18>>;
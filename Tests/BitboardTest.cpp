@@ -0,0 +1,140 @@
+// BitboardTest.cpp
+// Cross-checks BitboardState against the world it was built from, on both
+// board policies, over a random walk through a map scattered with boxes:
+// - legalSteps() has bit d set exactly when World::step moves the player in d
+// - BitboardState::step() lands on the same boxes and players as World::step,
+//   and reports a portal consume exactly when the player scored
+// - reachable() matches a breadth-first search, and lowest() its smallest cell
+#include "../include/Bitboard.hpp"
+#include "../include/Rng.hpp"
+
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+constexpr int kDx[4] = { 0, 0, -1, 1 };
+constexpr int kDy[4] = { -1, 1, 0, 0 };
+
+using State = BitboardState32x18;
+
+// Cells player 'p' can walk to, row-major: floor and portals, not the other player
+template <class WorldT>
+std::vector<char> reachableByBfs(const WorldT& w, int p) {
+    const int width = w.width();
+    std::vector<char> seen(static_cast<std::size_t>(width * w.height()), 0);
+    const int other = w.player(1 - p).y * width + w.player(1 - p).x;
+    std::vector<int> queue(1, w.player(p).y * width + w.player(p).x);
+    seen[static_cast<std::size_t>(queue[0])] = 1;
+    for (std::size_t head = 0; head < queue.size(); ++head) {
+        const int c = queue[head];
+        for (int d = 0; d < 4; ++d) {
+            const int x = c % width + kDx[d];
+            const int y = c / width + kDy[d];
+            if (x < 0 || y < 0 || x >= width || y >= w.height()) continue;
+            const int n = y * width + x;
+            const TileType t = w.tileAt(x, y);
+            if (seen[static_cast<std::size_t>(n)] || n == other || !(t == TileType::Floor || t == TileType::Portal)) continue;
+            seen[static_cast<std::size_t>(n)] = 1;
+            queue.push_back(n);
+        }
+    }
+    return seen;
+}
+
+template <class WorldT>
+int runWalk(std::uint64_t seed, int ticks) {
+    WorldConfig config;
+    config.spawnIntervalTicks = 1 << 30; // no spawns: a stepped copy must differ only by the step
+    config.moveIntervalTicks = 1;
+    config.gameDurationSec = 1 << 20;
+    config.seed = seed;
+    WorldT w(config);
+
+    Rng rng(seed);
+    for (int k = 0; k < 200; ++k) {
+        const int x = static_cast<int>(rng.below(32));
+        const int y = static_cast<int>(rng.below(18));
+        const bool occupied = (w.player(0).x == x && w.player(0).y == y) || (w.player(1).x == x && w.player(1).y == y);
+        if (w.tileAt(x, y) == TileType::Floor && !occupied) w.setTileAt(x, y, TileType::PushableBox);
+    }
+
+    int failures = 0;
+    Inputs in;
+    for (int t = 0; t < ticks && failures < 10; ++t) {
+        State s;
+        if (!State::fromWorld(w, s)) {
+            std::printf("fromWorld rejected a %dx%d world\n", w.width(), w.height());
+            return 1;
+        }
+        for (int p = 0; p < 2; ++p) {
+            const int legal = s.legalSteps(p);
+            for (int d = 0; d < 4; ++d) {
+                WorldT stepped = w;
+                Inputs one;
+                one.player[p].dx = kDx[d];
+                one.player[p].dy = kDy[d];
+                stepped.step(one);
+                const bool moved = stepped.player(p).x != w.player(p).x || stepped.player(p).y != w.player(p).y;
+                if (moved != ((legal >> d & 1) != 0)) {
+                    std::printf("seed %llu tick %d: player %d dir %d legalSteps %d, world %s\n",
+                                static_cast<unsigned long long>(seed), t, p, d, legal >> d & 1, moved ? "moved" : "blocked");
+                    ++failures;
+                }
+                if (!moved || !(legal >> d & 1)) continue;
+
+                State next = s;
+                const bool consumed = next.step(p, d);
+                State expected;
+                State::fromWorld(stepped, expected);
+                const bool scored = stepped.player(p).score != w.player(p).score;
+                if (next.boxes != expected.boxes || next.players != expected.players || consumed != scored) {
+                    std::printf("seed %llu tick %d: player %d dir %d: step() differs from World::step\n",
+                                static_cast<unsigned long long>(seed), t, p, d);
+                    ++failures;
+                }
+            }
+
+            const std::vector<char> seen = reachableByBfs(w, p);
+            const Bitboard32x18 region = s.reachable(p);
+            int lowest = -1;
+            for (int c = 0; c < 32 * 18; ++c) {
+                if (seen[static_cast<std::size_t>(c)] && lowest < 0) lowest = c;
+                if (region.test(c) == (seen[static_cast<std::size_t>(c)] != 0)) continue;
+                std::printf("seed %llu tick %d: player %d reachable() differs at cell %d\n",
+                            static_cast<unsigned long long>(seed), t, p, c);
+                ++failures;
+                break;
+            }
+            if (region.lowest() != lowest) {
+                std::printf("seed %llu tick %d: player %d lowest() %d, expected %d\n", static_cast<unsigned long long>(seed),
+                            t, p, region.lowest(), lowest);
+                ++failures;
+            }
+        }
+
+        for (PlayerInput& p : in.player) {
+            const std::uint32_t r = rng.below(5);
+            p.dx = (r == 1) - (r == 2);
+            p.dy = (r == 3) - (r == 4);
+        }
+        w.step(in);
+    }
+    return failures;
+}
+
+} // namespace
+
+int main() {
+    int failures = 0;
+    for (std::uint64_t seed = 1; seed <= 3; ++seed) {
+        failures += runWalk<World>(seed, 3000);
+        failures += runWalk<World32x18>(seed, 3000);
+    }
+    if (failures) {
+        std::printf("BitboardTest: %d failures\n", failures);
+        return 1;
+    }
+    std::printf("BitboardTest: ok\n");
+    return 0;
+}
@@ -0,0 +1,138 @@
+// DeadlockTest.cpp
+// Checks the world's incremental deadlock bookkeeping against full rescans,
+// over random matches with random level edits mixed in:
+// - isFrozenBox() matches the exact greatest fixpoint of the freeze rule
+//   (start from every box frozen, release any box with a free axis)
+// - freeCellCount() matches a recount of the cells a box could spawn into
+#include "../include/Rng.hpp"
+#include "../include/World.hpp"
+
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+bool isWall(const World& w, int x, int y) {
+    return x < 0 || y < 0 || x >= w.width() || y >= w.height() || w.tileAt(x, y) == TileType::Box;
+}
+
+// Frozen boxes by rescanning until nothing changes; row-major map cells
+std::vector<char> frozenByFixpoint(const World& w) {
+    const int width = w.width();
+    const int height = w.height();
+    std::vector<char> frozen(static_cast<std::size_t>(width * height), 0);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) frozen[static_cast<std::size_t>(y * width + x)] = w.tileAt(x, y) == TileType::PushableBox;
+    }
+    for (bool changed = true; changed; ) {
+        changed = false;
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                char& self = frozen[static_cast<std::size_t>(y * width + x)];
+                if (!self) continue;
+                bool stuck = true;
+                for (int axis = 0; axis < 2 && stuck; ++axis) {
+                    const int dx = axis;
+                    const int dy = 1 - axis;
+                    const int ax = x - dx, ay = y - dy, bx = x + dx, by = y + dy;
+                    if (isWall(w, ax, ay) || isWall(w, bx, by)) continue;
+                    if (w.isDeadSquare(ax, ay) && w.isDeadSquare(bx, by)) continue;
+                    if (frozen[static_cast<std::size_t>(ay * width + ax)] || frozen[static_cast<std::size_t>(by * width + bx)]) continue;
+                    stuck = false;
+                }
+                if (!stuck) {
+                    self = 0;
+                    changed = true;
+                }
+            }
+        }
+    }
+    return frozen;
+}
+
+int countFreeCells(const World& w) {
+    // With no reachable portal every square is dead, and the spawner ignores them
+    const bool avoidDead = w.deadlockTable().liveCount() > 0;
+    int free = 0;
+    for (int y = 0; y < w.height(); ++y) {
+        for (int x = 0; x < w.width(); ++x) {
+            const bool occupied = (w.player(0).x == x && w.player(0).y == y) || (w.player(1).x == x && w.player(1).y == y);
+            if (w.tileAt(x, y) == TileType::Floor && !occupied && !(avoidDead && w.isDeadSquare(x, y))) ++free;
+        }
+    }
+    return free;
+}
+
+// A random tile edit or player move on a cell no player stands on
+void randomEdit(World& w, Rng& rng) {
+    const int x = static_cast<int>(rng.below(static_cast<std::uint32_t>(w.width())));
+    const int y = static_cast<int>(rng.below(static_cast<std::uint32_t>(w.height())));
+    for (int p = 0; p < 2; ++p) {
+        if (w.player(p).x == x && w.player(p).y == y) return;
+    }
+    const std::uint32_t kind = rng.below(8);
+    if (kind < 4) w.setTileAt(x, y, TileType::PushableBox);
+    else if (kind < 6) w.setTileAt(x, y, TileType::Floor);
+    else if (kind == 6) w.setTileAt(x, y, TileType::Box);
+    else if (w.tileAt(x, y) == TileType::Floor) w.placePlayer(static_cast<int>(rng.below(2)), x, y);
+}
+
+int runMatch(const WorldConfig& config, std::uint64_t seed, int ticks) {
+    World w(config);
+    Rng rng(seed);
+    Inputs in;
+    int failures = 0;
+    for (int t = 0; t < ticks && failures < 10; ++t) {
+        for (PlayerInput& p : in.player) {
+            const std::uint32_t r = rng.below(5);
+            p.dx = (r == 1) - (r == 2);
+            p.dy = (r == 3) - (r == 4);
+        }
+        w.step(in);
+        if (rng.below(16) == 0) randomEdit(w, rng);
+
+        const std::vector<char> expected = frozenByFixpoint(w);
+        for (int y = 0; y < w.height(); ++y) {
+            for (int x = 0; x < w.width(); ++x) {
+                const bool want = expected[static_cast<std::size_t>(y * w.width() + x)] != 0;
+                if (w.isFrozenBox(x, y) == want) continue;
+                std::printf("seed %llu tick %d: box at (%d, %d) %s\n", static_cast<unsigned long long>(seed), t, x, y,
+                            want ? "frozen but not flagged" : "flagged frozen but can move");
+                ++failures;
+            }
+        }
+        const int free = countFreeCells(w);
+        if (w.freeCellCount() != free) {
+            std::printf("seed %llu tick %d: freeCellCount() %d, recount %d\n", static_cast<unsigned long long>(seed), t,
+                        w.freeCellCount(), free);
+            ++failures;
+        }
+    }
+    return failures;
+}
+
+} // namespace
+
+int main() {
+    WorldConfig crowded; // boxes pile up quickly, so freezes chain
+    crowded.spawnIntervalTicks = 3;
+    crowded.gameDurationSec = 100000;
+
+    WorldConfig small = crowded;
+    small.width = 12;
+    small.height = 7;
+
+    int failures = 0;
+    for (std::uint64_t seed = 1; seed <= 3; ++seed) {
+        crowded.seed = seed;
+        small.seed = seed;
+        failures += runMatch(crowded, seed, 4000);
+        failures += runMatch(small, seed + 100, 4000);
+    }
+    if (failures) {
+        std::printf("DeadlockTest: %d failures\n", failures);
+        return 1;
+    }
+    std::printf("DeadlockTest: ok\n");
+    return 0;
+}
@@ -0,0 +1,125 @@
+// VecWorldTest.cpp
+// Checks a batch against independently stepped worlds, on both board policies,
+// over seeded random actions long enough for matches to end and restart:
+// - observations() equals a full re-render of each match after every step
+// - rewards() are each player's score change and dones() the match end, as
+//   seen by a copy of the world stepped with the same inputs
+// - the per-match stateHash() sequence is identical with 1 and with 3 threads
+#include "../include/Rng.hpp"
+#include "../include/VecWorld.hpp"
+
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+constexpr int kMatches = 8;
+constexpr int kSteps = 4000;
+
+int failures = 0;
+
+// The observation writeObservation() would produce from scratch
+template <class Board>
+void render(const BasicWorld<Board>& w, std::vector<std::uint8_t>& out) {
+    using Vec = BasicVecWorld<Board>;
+    const int cells = w.width() * w.height();
+    out.assign(static_cast<std::size_t>(Vec::kPlanes * cells), 0);
+    for (int y = 0; y < w.height(); ++y) {
+        for (int x = 0; x < w.width(); ++x) {
+            const std::size_t cell = static_cast<std::size_t>(y * w.width() + x);
+            const TileType t = w.tileAt(x, y);
+            out[Vec::kPlaneWalls * cells + cell] = t == TileType::Box;
+            out[Vec::kPlaneBoxes * cells + cell] = t == TileType::PushableBox;
+            out[Vec::kPlanePortals * cells + cell] = t == TileType::Portal;
+        }
+    }
+    for (int p = 0; p < 2; ++p) {
+        out[static_cast<std::size_t>((Vec::kPlanePlayer1 + p) * cells + w.player(p).y * w.width() + w.player(p).x)] = 1;
+    }
+}
+
+PlayerInput inputOf(std::uint8_t action) {
+    static constexpr PlayerInput kSteps[] = { { 0, 0 }, { 0, -1 }, { 0, 1 }, { -1, 0 }, { 1, 0 } };
+    return action < 5 ? kSteps[action] : PlayerInput();
+}
+
+// Runs the batch and returns every match's stateHash() after every step
+template <class Board>
+std::vector<std::uint64_t> run(int threads) {
+    WorldConfig config = WorldConfig::forTickRate(60);
+    config.moveIntervalTicks = 1;
+    config.spawnIntervalTicks = 10;
+    config.gameDurationSec = 10; // every match ends and restarts several times
+    BasicVecWorld<Board> batch(kMatches, config, threads);
+
+    std::vector<BasicWorld<Board>> shadow;
+    for (int m = 0; m < kMatches; ++m) shadow.push_back(batch.world(m));
+    std::vector<std::uint64_t> hashes;
+    std::vector<std::uint8_t> expected;
+    Rng rng(25);
+
+    for (int t = 0; t < kSteps && failures < 10; ++t) {
+        for (int a = 0; a < kMatches * 2; ++a) batch.actions()[a] = static_cast<std::uint8_t>(rng.below(6)); // 5 = out of range
+        batch.step();
+
+        for (int m = 0; m < kMatches; ++m) {
+            const BasicWorld<Board>& w = batch.world(m);
+            BasicWorld<Board>& s = shadow[static_cast<std::size_t>(m)];
+            const int before[2] = { s.player(0).score, s.player(1).score };
+            Inputs in;
+            in.player[0] = inputOf(batch.actions()[m * 2]);
+            in.player[1] = inputOf(batch.actions()[m * 2 + 1]);
+            s.step(in);
+
+            for (int p = 0; p < 2; ++p) {
+                if (batch.rewards()[m * 2 + p] == static_cast<float>(s.player(p).score - before[p])) continue;
+                std::printf("%d threads, step %d, match %d: reward %g, score change %d\n", threads, t, m,
+                            batch.rewards()[m * 2 + p], s.player(p).score - before[p]);
+                ++failures;
+            }
+            if ((batch.dones()[m] != 0) != s.isGameOver()) {
+                std::printf("%d threads, step %d, match %d: done %d, match over %d\n", threads, t, m, batch.dones()[m],
+                            s.isGameOver() ? 1 : 0);
+                ++failures;
+            }
+            if (s.isGameOver()) s = w; // the batch restarted it with a fresh seed
+            else if (s.stateHash() != w.stateHash()) {
+                std::printf("%d threads, step %d, match %d: batch world differs from a lone world\n", threads, t, m);
+                ++failures;
+                s = w;
+            }
+
+            render(w, expected);
+            const std::uint8_t* obs = batch.observations() + static_cast<std::size_t>(m) * batch.observationSize();
+            if (expected.size() != batch.observationSize() || !std::equal(expected.begin(), expected.end(), obs)) {
+                std::printf("%d threads, step %d, match %d: observation differs from a full render\n", threads, t, m);
+                ++failures;
+            }
+            hashes.push_back(w.stateHash());
+        }
+    }
+    return hashes;
+}
+
+template <class Board>
+void checkThreads(const char* name) {
+    const std::vector<std::uint64_t> single = run<Board>(1);
+    const std::vector<std::uint64_t> multi = run<Board>(3);
+    if (single != multi) {
+        std::printf("%s: per-match state hashes differ between 1 and 3 threads\n", name);
+        ++failures;
+    }
+}
+
+} // namespace
+
+int main() {
+    checkThreads<DynamicBoard>("VecWorld");
+    checkThreads<FixedBoard<32, 18>>("VecWorld32x18");
+    if (failures) {
+        std::printf("VecWorldTest: %d failures\n", failures);
+        return 1;
+    }
+    std::printf("VecWorldTest: ok\n");
+    return 0;
+}
@@ -0,0 +1,88 @@
+// Solve.cpp
+// Command-line front end for the puzzle solver: solves every level of an XSB
+// file and prints one CSV row per level:
+//   level,title,algorithm,threads,solved,pushes,moves,nodes,seconds,nodes_per_sec,verified,expected
+// 'expected' is the level's known optimal push count ("Pushes: n"), empty if
+// unknown. A solution that doesn't replay, or that misses a known optimum,
+// makes the exit status nonzero.
+//
+//   --ida             use IDA* instead of A*
+//   --portal          game rules (a goal consumes the box) instead of standard Sokoban
+//   --level <n>       only solve level n (1-based)
+//   --max-nodes <n>   expansion budget per level
+//   --table-bits <n>  IDA* transposition table size limit (2^n entries)
+//   --threads <n>     IDA* worker threads (default 1 = deterministic, 0 = all cores)
+//   --show            also print each level and its LURD solution
+#include "../include/Puzzle.hpp"
+#include "../include/Solver.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+int main(int argc, char* argv[]) {
+    SolverOptions options;
+    PuzzleRules rules = PuzzleRules::Standard;
+    const char* path = nullptr;
+    int onlyLevel = 0;
+    bool show = false;
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--ida") == 0) {
+            options.algorithm = SearchAlgorithm::IdaStar;
+        } else if (std::strcmp(argv[i], "--portal") == 0) {
+            rules = PuzzleRules::Portal;
+        } else if (std::strcmp(argv[i], "--level") == 0 && hasValue) {
+            onlyLevel = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--max-nodes") == 0 && hasValue) {
+            options.maxNodes = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--table-bits") == 0 && hasValue) {
+            options.tableBits = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--threads") == 0 && hasValue) {
+            options.threads = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--show") == 0) {
+            show = true;
+        } else if (argv[i][0] != '-' && !path) {
+            path = argv[i];
+        } else {
+            path = nullptr;
+            break;
+        }
+    }
+    if (!path) {
+        std::fprintf(stderr, "usage: %s [--ida] [--portal] [--level n] [--max-nodes n] [--table-bits n] [--threads n] [--show] levels.xsb\n",
+                     argv[0]);
+        return 2;
+    }
+
+    std::vector<PuzzleLevel> levels = loadXsbFile(path);
+    if (levels.empty()) {
+        std::fprintf(stderr, "No levels in %s\n", path);
+        return 1;
+    }
+
+    const char* algorithm = options.algorithm == SearchAlgorithm::IdaStar ? "ida*" : "a*";
+    int failures = 0;
+    std::printf("level,title,algorithm,threads,solved,pushes,moves,nodes,seconds,nodes_per_sec,verified,expected\n");
+    for (int n = 1; n <= static_cast<int>(levels.size()); ++n) {
+        if (onlyLevel && n != onlyLevel) continue;
+        PuzzleLevel& level = levels[static_cast<std::size_t>(n - 1)];
+        level.rules = rules;
+
+        Solver solver(level);
+        const SolverResult r = solver.solve(options);
+        const bool verified = r.solved && checkSolution(level, r.solution);
+        if (r.solved && !verified) ++failures; // a solution that doesn't replay is a solver bug
+        if (r.solved && level.expectedPushes >= 0 && r.pushes != level.expectedPushes) ++failures; // not optimal
+
+        const std::string expected = level.expectedPushes >= 0 ? std::to_string(level.expectedPushes) : std::string();
+        std::printf("%d,\"%s\",%s,%d,%s,%d,%zu,%llu,%.3f,%.0f,%d,%s\n", n, level.title.c_str(), algorithm, r.threads,
+                    r.solved ? "yes" : (r.unsolvable ? "unsolvable" : "gave-up"), r.pushes, r.solution.size(),
+                    static_cast<unsigned long long>(r.nodes), r.seconds, r.nodesPerSecond(), verified ? 1 : 0,
+                    expected.c_str());
+        if (show) std::printf("%s%s\n\n", toXsb(level).c_str(), r.solution.c_str());
+        std::fflush(stdout);
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,29 @@
+// AllocStats.hpp
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// --- Heap allocation counters ---
+// Source/AllocStats.cpp replaces the global operator new/delete with versions
+// that count every call. Linking it into a binary is enough to enable it; the
+// soak mode uses the counters to prove that World::step() never allocates.
+namespace allocstats {
+
+struct Snapshot {
+    std::uint64_t allocations = 0;
+    std::uint64_t frees = 0;
+    std::uint64_t bytes = 0;
+};
+
+Snapshot current();
+
+// Difference between two snapshots (later - earlier)
+inline Snapshot since(const Snapshot& earlier) {
+    Snapshot now = current();
+    now.allocations -= earlier.allocations;
+    now.frees -= earlier.frees;
+    now.bytes -= earlier.bytes;
+    return now;
+}
+
+} // namespace allocstats
@@ -0,0 +1,274 @@
+// Bitboard.hpp
+#pragma once
+#include <cassert>
+#include <cstdint>
+
+#include "World.hpp"
+
+namespace detail {
+
+// Valid-cell and column masks, built at compile time
+template <int W, int H, int Words>
+struct BitboardMasks {
+    std::uint64_t valid[Words];
+    std::uint64_t notFirstColumn[Words];
+    std::uint64_t notLastColumn[Words];
+
+    static constexpr BitboardMasks make() {
+        BitboardMasks m{};
+        for (int c = 0; c < W * H; ++c) {
+            const std::uint64_t bit = std::uint64_t(1) << (c % 64);
+            m.valid[c / 64] |= bit;
+            if (c % W != 0) m.notFirstColumn[c / 64] |= bit;
+            if (c % W != W - 1) m.notLastColumn[c / 64] |= bit;
+        }
+        return m;
+    }
+};
+
+} // namespace detail
+
+// --- Bitboard: one bit per cell of a fixed W x H board, row-major ---
+// Cell c = y * W + x is bit c % 64 of word c / 64. Every operation is a short
+// fixed-trip loop over kWords, so the compiler unrolls it and, with AVX2
+// enabled (SOKUBAN_NATIVE), vectorizes it. Bits past the last cell stay zero.
+// Neighbor shifts move every set cell one step and drop what leaves the board.
+template <int W, int H>
+class Bitboard {
+public:
+    static constexpr int kWidth = W;
+    static constexpr int kHeight = H;
+    static constexpr int kCells = W * H;
+    static constexpr int kWords = (kCells + 63) / 64;
+
+    constexpr Bitboard() : w{} {}
+
+    static constexpr Bitboard all() { return fromWords(kMasks.valid); }
+    static Bitboard single(int cell) {
+        Bitboard b;
+        b.set(cell);
+        return b;
+    }
+
+    bool test(int cell) const { return (w[cell >> 6] >> (cell & 63)) & 1u; }
+    void set(int cell) { w[cell >> 6] |= std::uint64_t(1) << (cell & 63); }
+    void reset(int cell) { w[cell >> 6] &= ~(std::uint64_t(1) << (cell & 63)); }
+
+    Bitboard& operator|=(const Bitboard& o) { for (int i = 0; i < kWords; ++i) w[i] |= o.w[i]; return *this; }
+    Bitboard& operator&=(const Bitboard& o) { for (int i = 0; i < kWords; ++i) w[i] &= o.w[i]; return *this; }
+    Bitboard& operator^=(const Bitboard& o) { for (int i = 0; i < kWords; ++i) w[i] ^= o.w[i]; return *this; }
+    friend Bitboard operator|(Bitboard a, const Bitboard& b) { return a |= b; }
+    friend Bitboard operator&(Bitboard a, const Bitboard& b) { return a &= b; }
+    friend Bitboard operator^(Bitboard a, const Bitboard& b) { return a ^= b; }
+
+    // Complement within the board
+    Bitboard operator~() const {
+        Bitboard r;
+        for (int i = 0; i < kWords; ++i) r.w[i] = ~w[i] & kMasks.valid[i];
+        return r;
+    }
+    Bitboard andNot(const Bitboard& o) const {
+        Bitboard r;
+        for (int i = 0; i < kWords; ++i) r.w[i] = w[i] & ~o.w[i];
+        return r;
+    }
+
+    bool operator==(const Bitboard& o) const {
+        std::uint64_t diff = 0;
+        for (int i = 0; i < kWords; ++i) diff |= w[i] ^ o.w[i];
+        return diff == 0;
+    }
+    bool operator!=(const Bitboard& o) const { return !(*this == o); }
+
+    bool any() const {
+        std::uint64_t acc = 0;
+        for (int i = 0; i < kWords; ++i) acc |= w[i];
+        return acc != 0;
+    }
+    bool none() const { return !any(); }
+
+    int count() const {
+        int n = 0;
+        for (int i = 0; i < kWords; ++i) n += popcount(w[i]);
+        return n;
+    }
+
+    // Lowest set cell, -1 if empty (a canonical cell for a region, e.g. a normalized player)
+    int lowest() const {
+        for (int i = 0; i < kWords; ++i) {
+            if (w[i]) return i * 64 + popcount((w[i] & (0 - w[i])) - 1);
+        }
+        return -1;
+    }
+
+    // --- Neighbor shifts: dir 0..3 = up, down, left, right (World/solver order) ---
+    Bitboard up() const { return shiftedDown(W); }    // cell c -> c - W
+    Bitboard down() const { return shiftedUp(W); }    // cell c -> c + W
+    Bitboard left() const { return andMask(kMasks.notFirstColumn).shiftedDown(1); }
+    Bitboard right() const { return andMask(kMasks.notLastColumn).shiftedUp(1); }
+
+    Bitboard shifted(int dir) const {
+        switch (dir) {
+            case 0: return up();
+            case 1: return down();
+            case 2: return left();
+            default: return right();
+        }
+    }
+
+    // Every cell plus its four neighbors
+    Bitboard dilated() const { return *this | up() | down() | left() | right(); }
+
+    const std::uint64_t* words() const { return w; }
+
+private:
+    using Masks = detail::BitboardMasks<W, H, kWords>;
+    static constexpr Masks kMasks = Masks::make();
+
+    static constexpr Bitboard fromWords(const std::uint64_t (&src)[kWords]) {
+        Bitboard b;
+        for (int i = 0; i < kWords; ++i) b.w[i] = src[i];
+        return b;
+    }
+
+    Bitboard andMask(const std::uint64_t (&mask)[kWords]) const {
+        Bitboard r;
+        for (int i = 0; i < kWords; ++i) r.w[i] = w[i] & mask[i];
+        return r;
+    }
+
+    // Towards higher cells by n bits (0 < n); the top is trimmed to the board
+    Bitboard shiftedUp(int n) const {
+        const int words = n / 64;
+        const int bits = n % 64;
+        Bitboard r;
+        for (int i = kWords - 1; i >= words; --i) {
+            std::uint64_t v = w[i - words] << bits;
+            if (bits && i - words - 1 >= 0) v |= w[i - words - 1] >> (64 - bits);
+            r.w[i] = v & kMasks.valid[i];
+        }
+        return r;
+    }
+
+    // Towards lower cells by n bits (0 < n)
+    Bitboard shiftedDown(int n) const {
+        const int words = n / 64;
+        const int bits = n % 64;
+        Bitboard r;
+        for (int i = 0; i + words < kWords; ++i) {
+            std::uint64_t v = w[i + words] >> bits;
+            if (bits && i + words + 1 < kWords) v |= w[i + words + 1] << (64 - bits);
+            r.w[i] = v;
+        }
+        return r;
+    }
+
+    static int popcount(std::uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_popcountll(v);
+#else
+        int n = 0;
+        for (; v; v &= v - 1) ++n;
+        return n;
+#endif
+    }
+
+    std::uint64_t w[kWords];
+};
+
+// --- BitboardState: a whole position as layers, for solvers and bots ---
+// walls = immovable Box tiles, boxes = pushable boxes, portals = box-consuming
+// cells, players = both players. Moves follow World::tryMovePlayer for one
+// player at a time (the simultaneous-move conflict rules are the caller's).
+template <int W, int H>
+struct BitboardState {
+    using Board = Bitboard<W, H>;
+
+    Board walls;
+    Board boxes;
+    Board portals;
+    Board players;
+    int playerCell[2] = { 0, 0 };
+
+    // false if the world is not W x H
+    template <class WorldBoard>
+    static bool fromWorld(const BasicWorld<WorldBoard>& world, BitboardState& out) {
+        if (world.width() != W || world.height() != H) return false;
+        out = BitboardState();
+        for (int y = 0; y < H; ++y) {
+            const TileType* row = world.tileData() + world.cellAt(0, y);
+            for (int x = 0; x < W; ++x) {
+                const int cell = y * W + x;
+                switch (row[x]) {
+                    case TileType::Box: out.walls.set(cell); break;
+                    case TileType::PushableBox: out.boxes.set(cell); break;
+                    case TileType::Portal: out.portals.set(cell); break;
+                    default: break;
+                }
+            }
+        }
+        for (int p = 0; p < 2; ++p) {
+            out.playerCell[p] = world.player(p).y * W + world.player(p).x;
+            out.players.set(out.playerCell[p]);
+        }
+        return true;
+    }
+
+    // Cells a box may be pushed onto: floor or portal, no box, no player
+    Board boxTargets() const { return (~walls).andNot(boxes).andNot(players); }
+
+    // Cells 'playerIndex' can walk to without pushing: flood fill by whole-board shifts
+    Board reachable(int playerIndex) const {
+        const Board open = (~walls).andNot(boxes).andNot(Board::single(playerCell[1 - playerIndex]));
+        Board region = Board::single(playerCell[playerIndex]);
+        for (;;) {
+            const Board grown = region.dilated() & open;
+            if (grown == region) return region;
+            region = grown;
+        }
+    }
+
+    // Boxes that can be pushed in 'dir' by a player standing anywhere in 'region':
+    // the cell behind the box is in the region and the cell ahead takes a box
+    Board pushable(int dir, const Board& region) const {
+        return boxes & region.shifted(dir) & boxTargets().shifted(dir ^ 1);
+    }
+
+    // Bit d set if a step in direction d moves the player (walk or push) right now
+    int legalSteps(int playerIndex) const {
+        const Board self = Board::single(playerCell[playerIndex]);
+        const Board other = Board::single(playerCell[1 - playerIndex]);
+        const Board walkable = (~walls).andNot(boxes).andNot(other);
+        int mask = 0;
+        for (int d = 0; d < 4; ++d) {
+            const Board ahead = self.shifted(d);
+            if ((ahead & walkable).any() || (ahead & boxes & boxTargets().shifted(d ^ 1)).any()) mask |= 1 << d;
+        }
+        return mask;
+    }
+
+    // Applies a legal step; returns true if it pushed a box into a portal.
+    // Precondition: bit 'dir' of legalSteps(playerIndex) is set. Nothing is
+    // checked in release builds, and an illegal step corrupts the state.
+    bool step(int playerIndex, int dir) {
+        assert((legalSteps(playerIndex) >> dir & 1) && "BitboardState::step needs a legal step");
+        static constexpr int kDelta[4] = { -W, W, -1, 1 };
+        const int from = playerCell[playerIndex];
+        const int to = from + kDelta[dir];
+        bool consumed = false;
+        if (boxes.test(to)) {
+            const int boxTo = to + kDelta[dir];
+            boxes.reset(to);
+            consumed = portals.test(boxTo);
+            if (!consumed) boxes.set(boxTo);
+        }
+        players.reset(from);
+        players.set(to);
+        playerCell[playerIndex] = to;
+        return consumed;
+    }
+};
+
+// The shipped map size (WorldConfig defaults): 576 cells, nine words per layer
+using Bitboard32x18 = Bitboard<32, 18>;
+using BitboardState32x18 = BitboardState<32, 18>;
@@ -0,0 +1,46 @@
+// CpuRasterizer.hpp
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "GameView.hpp"
+#include "TextureAtlas.hpp"
+#include "World.hpp"
+
+// --- CpuRasterizer: pure-software fallback for offscreen rendering ---
+// Draws the same board, players and HUD as GameView straight into an RGBA
+// buffer, sampling the atlas image (nearest neighbor). Needs no GL context,
+// so it runs on display-less build hosts. HUD text uses a built-in 3x5 pixel
+// font instead of the TrueType font, so glyphs differ from the GPU path.
+class CpuRasterizer {
+public:
+    // atlas must outlive the rasterizer (only its CPU-side image is used)
+    CpuRasterizer(const TextureAtlas& atlas, int mapW, int mapH, float tile = kTileSize);
+
+    void render(const World& world);
+
+    unsigned width() const { return w; }
+    unsigned height() const { return h; }
+    const std::uint8_t* pixels() const { return buffer.data(); }
+
+    bool savePng(const std::string& path) const;
+
+private:
+    struct Rgba {
+        std::uint8_t r, g, b, a;
+    };
+
+    void fillRect(int x, int y, int rw, int rh, Rgba color);
+    void blit(AtlasImage image, int x, int y, int size);
+    void drawText(const char* text, int x, int y, int scale, Rgba color);
+    static int textWidth(const char* text, int scale); // glyph advances, as drawText moves
+
+    const TextureAtlas& atlas;
+    int mapW;
+    int mapH;
+    float tile;
+    unsigned w;
+    unsigned h;
+    std::vector<std::uint8_t> buffer; // RGBA8, row-major
+};
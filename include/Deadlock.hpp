@@ -0,0 +1,91 @@
+// Deadlock.hpp
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// --- CellBitset: one bit per grid cell, O(1) test/set ---
+class CellBitset {
+public:
+    // Resizes and clears; keeps its buffer, so a same-size resize does not allocate
+    void resize(int cells) {
+        cellCount = cells;
+        words.assign(static_cast<std::size_t>((cells + 63) / 64), 0);
+    }
+
+    void clear() { std::fill(words.begin(), words.end(), 0); }
+
+    // Sets every cell (bits past size() stay clear)
+    void fill() {
+        std::fill(words.begin(), words.end(), ~std::uint64_t(0));
+        if (cellCount & 63) words.back() = (std::uint64_t(1) << (cellCount & 63)) - 1;
+    }
+
+    bool test(int cell) const { return (words[word(cell)] >> (cell & 63)) & 1u; }
+    void set(int cell) { words[word(cell)] |= std::uint64_t(1) << (cell & 63); }
+    void reset(int cell) { words[word(cell)] &= ~(std::uint64_t(1) << (cell & 63)); }
+    void assign(int cell, bool on) { on ? set(cell) : reset(cell); }
+
+    int size() const { return cellCount; }
+    int count() const;
+
+    // Raw words (bit c % 64 of word c / 64 is cell c), for callers combining whole masks
+    const std::uint64_t* data() const { return words.data(); }
+
+private:
+    static std::size_t word(int cell) { return static_cast<std::size_t>(cell) >> 6; }
+
+    std::vector<std::uint64_t> words;
+    int cellCount = 0;
+};
+
+// --- Per-map deadlock tables for the game, the solver and bots ---
+// Dead squares: a box on one can never be pushed onto a goal (portal). Found by
+// pulling a box backwards from every goal; cells no pull reaches are dead.
+// Only walls are considered, so the table depends on the static layout and is
+// rebuilt with it.
+// Freeze deadlocks: a box that can move along neither axis, because each axis
+// is blocked by a wall, by dead squares on both sides, or by another frozen box.
+class DeadlockTable {
+public:
+    static constexpr std::uint8_t kWall = 1; // same bits as PuzzleLevel::cells
+    static constexpr std::uint8_t kGoal = 2;
+
+    // Row-major kWall / kGoal flags; everything outside the board counts as wall.
+    // Reuses its buffers, so rebuilding a same-size board does not allocate. An
+    // unchanged board is detected by comparing every cell (O(cells), but no pull
+    // search). Boards up to 65535 cells wide.
+    void build(int width, int height, const std::uint8_t* board);
+
+    int width() const { return boardWidth; }
+    int height() const { return boardHeight; }
+
+    bool isDead(int cell) const { return dead.test(cell); }
+    const CellBitset& deadSquares() const { return dead; }
+    int liveCount() const { return live; } // 0 when the board has no reachable goal
+
+    // Would the box at 'cell' be frozen with boxes at 'boxes'? Boxes in 'known'
+    // are already frozen and act as walls, which keeps incremental callers cheap.
+    // Conservative: a check needing more than kFreezeBudget box visits answers "not frozen".
+    bool isFrozen(const CellBitset& boxes, int cell, const CellBitset* known = nullptr) const;
+
+    // Frozen, and the box or one that freezes it is off a goal: the position is lost.
+    // Under portal rules boxes never rest on goals, so this equals isFrozen().
+    bool isFreezeDeadlock(const CellBitset& boxes, int cell) const;
+
+    static constexpr int kFreezeBudget = 32;
+
+private:
+    struct Pin; // boxes already being tested, treated as walls below them
+    struct FreezeQuery;
+
+    bool isBlocked(int x, int y) const; // wall or off the board
+    bool frozen(FreezeQuery& q, int x, int y, const Pin* pinned, bool& offGoal) const;
+
+    int boardWidth = 0;
+    int boardHeight = 0;
+    std::vector<std::uint8_t> flags;
+    CellBitset dead;
+    std::vector<int> queue;
+    int live = 0;
+};
@@ -0,0 +1,39 @@
+// GameView.hpp
+#pragma once
+#include <SFML/Graphics.hpp>
+
+#include "Hud.hpp"
+#include "Profiler.hpp"
+#include "TextureAtlas.hpp"
+#include "TilemapRenderer.hpp"
+#include "World.hpp"
+
+constexpr float kTileSize = 37.f; // tile size in pixels
+
+// --- GameView: everything drawn for one World (board, players, HUD) ---
+// Renders to any sf::RenderTarget, so the window and offscreen render
+// textures share exactly the same drawing code.
+class GameView : public sf::Drawable {
+public:
+    // atlas (uploaded) and font must outlive the view
+    GameView(const TextureAtlas& atlas, const sf::Font& font, int mapW, int mapH, float tile = kTileSize);
+
+    // Pull the latest world state into the view. Player sprites are blended
+    // between prev and the current tick by alpha (0..1). Consumes the world's
+    // changed-cell list.
+    void update(World& world, const PlayerState prev[2], float alpha, Profiler* profiler = nullptr);
+
+    const Hud& hud() const { return hudView; }
+    const TilemapRenderer& board() const { return boardView; }
+    sf::Vector2u pixelSize() const { return size; }
+
+private:
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+    float tile;
+    sf::Vector2u size;
+    TilemapRenderer boardView;
+    Hud hudView;
+    sf::Sprite player1;
+    sf::Sprite player2;
+};
@@ -0,0 +1,43 @@
+// Hud.hpp
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+
+#include "World.hpp"
+
+// --- Per-frame HUD cost counters ---
+struct HudStats {
+    std::uint64_t updates = 0;   // update() calls
+    std::uint64_t rebuilds = 0;  // setString() calls (each one re-lays out glyphs)
+    std::uint64_t totalNs = 0;   // time spent in update()
+    std::uint64_t lastNs = 0;
+};
+
+// --- Hud: scores, countdown and winner banner ---
+// Text is only rebuilt when the value it shows changes (a score, the displayed
+// second, the game-over state). Numbers are formatted into fixed buffers, so a
+// frame where nothing changed costs a few integer compares.
+class Hud : public sf::Drawable {
+public:
+    // font must outlive the HUD; width/height are the board size in pixels
+    Hud(const sf::Font& font, float width, float height, float tileSize);
+
+    void update(const World& world);
+
+    const HudStats& stats() const { return counters; }
+
+private:
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+    sf::Text player1ScoreText;
+    sf::Text player2ScoreText;
+    sf::Text timerText;
+    sf::Text winnerText;
+
+    // Last values written into the texts (-1 => never written)
+    int shownScore[2] = { -1, -1 };
+    int shownSeconds = -1;
+    bool shownGameOver = false;
+
+    HudStats counters;
+};
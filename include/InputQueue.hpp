@@ -0,0 +1,82 @@
+// InputQueue.hpp
+#pragma once
+#include <cstdint>
+
+#include "World.hpp"
+
+// --- InputQueue: event-driven, timestamped player input for the sim tick ---
+// Window events (key down / key up) are pushed into a ring buffer as they arrive.
+// Each simulation tick drains that buffer into per-player move queues and held-key
+// state, then hands the World one step per player:
+//   - every key press becomes exactly one queued step, even if it was released
+//     before the next tick (short taps are never lost);
+//   - while a key stays held, the player keeps stepping at the World's move rate;
+//   - with several keys held, the most recently pressed one wins.
+// A queued step is only handed out when the World is ready to move that player,
+// so the cooldown never swallows a press. It leaves the queue on the next tick,
+// once step() applied it or a wall or box refused it; a step cancelled because
+// both players went for the same tile or a swap is handed out again. When both
+// players' queued steps cancelled each other, player 2's waits a tick, so the
+// retry does not repeat the conflict.
+
+enum class MoveDir : std::uint8_t { None, Up, Down, Left, Right };
+
+struct InputEvent {
+    int player = 0;              // 0 or 1
+    MoveDir dir = MoveDir::None;
+    bool pressed = false;        // false => key released
+    std::uint64_t timeUs = 0;    // when the event was received
+};
+
+// Event-to-step latency of each queued press the sim took (not cancelled)
+struct InputLatencyStats {
+    std::uint64_t samples = 0;
+    std::uint64_t totalUs = 0;
+    std::uint64_t maxUs = 0;
+    std::uint64_t dropped = 0;   // presses lost to a full queue (should stay 0)
+
+    std::uint64_t averageUs() const { return samples ? totalUs / samples : 0; }
+};
+
+class InputQueue {
+public:
+    static constexpr int kEventCapacity = 256; // raw events between two ticks
+    static constexpr int kMoveCapacity = 64;   // pending steps per player
+
+    // Called from the window event loop
+    void push(const InputEvent& ev);
+
+    // Forget held keys (e.g. on focus loss); queued presses are kept
+    void releaseAll();
+
+    // Called once per sim tick, before world.step(): settles the steps handed out
+    // last tick and builds this tick's Inputs for the given world
+    Inputs consume(const World& world, std::uint64_t nowUs);
+
+    const InputLatencyStats& latency() const { return stats; }
+
+private:
+    struct QueuedMove {
+        MoveDir dir;
+        std::uint64_t timeUs;
+    };
+
+    struct PlayerQueue {
+        QueuedMove moves[kMoveCapacity];
+        int head = 0;
+        int count = 0;
+        bool inFlight = false;      // moves[head] was handed to the last step()
+        std::uint64_t handedUs = 0; // when it was handed out
+        MoveDir held[4] = {};       // held keys, most recent last
+        int heldCount = 0;
+    };
+
+    void apply(const InputEvent& ev);
+
+    InputEvent events[kEventCapacity];
+    int eventHead = 0;
+    int eventCount = 0;
+    PlayerQueue players[2];
+    bool secondWaits = false; // both queued steps were cancelled: player 0 retries first
+    InputLatencyStats stats;
+};
@@ -0,0 +1,28 @@
+// Offscreen.hpp
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// --- Offscreen render mode: headless frame benchmark + golden images ---
+// Plays a scripted match (seeded random-walk inputs for both players) and
+// renders one frame per sim tick into an offscreen target instead of a
+// window: an sf::RenderTexture when a GL context is available, otherwise
+// (or with forceCpu) the CpuRasterizer. Selected frames are written as PNG;
+// frames per second is printed at the end.
+// With goldenDir set, the selected frames are instead compared pixel for pixel
+// with <goldenDir>/frame_NNNNN.png (every such file when none are selected).
+// That always uses the CpuRasterizer, whose output does not depend on a GPU or
+// driver. A frame that differs is written to outDir for inspection, and
+// runOffscreen() returns nonzero.
+struct OffscreenOptions {
+    int ticks = 3600;                 // frames to render (one per tick)
+    std::uint64_t seed = 1;           // world + input script seed
+    bool forceCpu = false;            // skip the GL path
+    std::vector<int> goldenFrames;    // frame indices to dump as PNG (or to compare)
+    std::string goldenDir;            // reference frames to compare against; empty => dump
+    std::string outDir = ".";
+    std::string assetDir = "Assets";  // atlas.png + atlas.txt, or the source images
+};
+
+int runOffscreen(const OffscreenOptions& options);
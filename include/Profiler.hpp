@@ -0,0 +1,91 @@
+// Profiler.hpp
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// --- Frame phases measured by the profiler ---
+enum class Phase : std::uint8_t {
+    Events,  // window event polling
+    Input,   // building per-tick Inputs from the input queue
+    Moves,   // World: player move / push resolution
+    Spawn,   // World: box spawner
+    Hud,     // HUD text updates
+    Board,   // tilemap sync (vertex updates)
+    Draw,    // draw calls for board, players, HUD
+    Display, // window.display() (buffer swap / vsync wait)
+    Frame,   // whole frame, start to end
+    Count
+};
+
+constexpr int kPhaseCount = static_cast<int>(Phase::Count);
+
+// --- Profiler: per-frame phase timings with a rolling history ---
+// Scoped timers add nanoseconds to the current frame; endFrame() stores the
+// frame in a ring of the last kHistory frames (for p50/p99) and optionally
+// appends it as one CSV row. No allocation after construction.
+class Profiler {
+public:
+    static constexpr int kHistory = 512;
+
+    Profiler();
+    ~Profiler();
+
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    void add(Phase phase, std::uint64_t ns) { current[static_cast<int>(phase)] += ns; }
+
+    void beginFrame();
+    void endFrame();
+
+    // Per-frame CSV dump (frame index + one ns column per phase); false if the file can't be opened
+    bool openCsv(const std::string& path);
+
+    struct Summary {
+        double p50Us = 0.0;
+        double p99Us = 0.0;
+    };
+
+    // Percentiles over the frames currently in the history
+    Summary summary(Phase phase) const;
+
+    std::uint64_t frames() const { return frameCount; }
+
+    static const char* name(Phase phase);
+
+private:
+    std::uint64_t current[kPhaseCount];
+    std::vector<std::uint64_t> history; // kHistory rows x kPhaseCount columns
+    mutable std::vector<std::uint64_t> scratch;
+    std::uint64_t frameCount = 0;
+    std::chrono::steady_clock::time_point frameStart;
+    std::FILE* csv = nullptr;
+};
+
+// --- ScopedTimer: adds the lifetime of the scope to a phase (no-op without a profiler) ---
+class ScopedTimer {
+public:
+    ScopedTimer(Profiler* profiler, Phase phase)
+    : profiler(profiler)
+    , phase(phase)
+    {
+        if (profiler) start = std::chrono::steady_clock::now();
+    }
+
+    ~ScopedTimer() {
+        if (!profiler) return;
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        profiler->add(phase, static_cast<std::uint64_t>(ns));
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    Profiler* profiler;
+    Phase phase;
+    std::chrono::steady_clock::time_point start;
+};
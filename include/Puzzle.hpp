@@ -0,0 +1,55 @@
+// Puzzle.hpp
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "World.hpp"
+
+// --- Puzzle levels for the solver and the level tools ---
+// A static single-player view of a board: walls, goals, boxes, one player.
+// Comes either from a World (game rules) or from standard XSB text:
+//   #  wall        $  box          .  goal
+//   @  player      *  box on goal  +  player on goal
+//   space, - or _  floor
+enum class PuzzleRules : std::uint8_t {
+    Standard, // classic Sokoban: solved when every box rests on a goal
+    Portal,   // this game: a box pushed onto a goal (portal) is consumed
+};
+
+struct PuzzleLevel {
+    static constexpr std::uint8_t kWall = 1;
+    static constexpr std::uint8_t kGoal = 2;
+
+    std::string title;
+    int width = 0;
+    int height = 0;
+    std::vector<std::uint8_t> cells; // row-major kWall / kGoal flags
+    std::vector<int> boxes;          // cell indices (y * width + x)
+    int player = -1;
+    PuzzleRules rules = PuzzleRules::Standard;
+    int expectedPushes = -1; // known push-optimal length ("Pushes: n"), -1 if unknown
+
+    bool isWall(int cell) const { return (cells[static_cast<std::size_t>(cell)] & kWall) != 0; }
+    bool isGoal(int cell) const { return (cells[static_cast<std::size_t>(cell)] & kGoal) != 0; }
+};
+
+// Every level in an XSB text (levels are separated by blank or non-board lines;
+// "Title: x" or "; x" lines name the level that follows or precedes them, and
+// "Pushes: n" gives its known push-optimal solution length)
+std::vector<PuzzleLevel> parseXsb(const std::string& text);
+
+// Reads and parses an .xsb/.sok file; empty if it can't be read
+std::vector<PuzzleLevel> loadXsbFile(const std::string& path);
+
+// The current board of a World as seen by one player under game rules:
+// Box => wall, PushableBox => box, Portal => goal. The other player is ignored
+// (it can move out of the way), and the map edge acts as a wall.
+PuzzleLevel puzzleFromWorld(const World& world, int playerIndex);
+
+// Back to XSB text (for logs)
+std::string toXsb(const PuzzleLevel& level);
+
+// Replays a LURD move string (lowercase walk, uppercase push) under the level's rules;
+// true if every move is legal and the level ends solved
+bool checkSolution(const PuzzleLevel& level, const std::string& lurd);
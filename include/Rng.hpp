@@ -0,0 +1,98 @@
+// Rng.hpp
+#pragma once
+#include <cstdint>
+
+// splitmix64 finalizer: a well-mixed 64-bit value for any input (seeding, hash keys)
+inline std::uint64_t mix64(std::uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// --- Rng: xoshiro256** generator, one independent stream per match ---
+// Small (32 bytes of state), fast and fully reproducible from (seed, stream).
+// jump() advances by 2^128 draws, so streams derived from the same seed with
+// different stream numbers never overlap in practice. Selecting stream k costs
+// k jumps (256 draws each): expand a (seed, stream) pair once and copy the Rng
+// to restart it, or fork() it for a fresh stream per restart, as World does,
+// rather than reseeding per restart.
+class Rng {
+public:
+    explicit Rng(std::uint64_t seed = 0, std::uint64_t stream = 0) { reseed(seed, stream); }
+
+    void reseed(std::uint64_t seed, std::uint64_t stream = 0) {
+        // Expand the 64-bit seed with splitmix64 (never yields the all-zero state)
+        std::uint64_t x = seed;
+        for (std::uint64_t& word : s) {
+            x += 0x9E3779B97F4A7C15ull;
+            word = mix64(x);
+        }
+        for (std::uint64_t i = 0; i < stream; ++i) jump();
+    }
+
+    std::uint64_t next() {
+        const std::uint64_t result = rotl(s[1] * 5, 7) * 9;
+        const std::uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+
+    // A reproducible sub-stream for 'key' (an episode number, say): this state
+    // with a splitmix64 expansion of the key XORed in. Four mixes and no jumps,
+    // so restarts derive fresh streams from one expanded state. Key 0 is this
+    // stream itself.
+    Rng fork(std::uint64_t key) const {
+        Rng r = *this;
+        if (key == 0) return r;
+        std::uint64_t x = mix64(key ^ 0x6A09E667F3BCC909ull); // keys never alias seeds
+        for (std::uint64_t& word : r.s) {
+            x += 0x9E3779B97F4A7C15ull;
+            word ^= mix64(x);
+        }
+        if (!(r.s[0] | r.s[1] | r.s[2] | r.s[3])) r.s[0] = 1; // the one state xoshiro cannot leave
+        return r;
+    }
+
+    // Unbiased integer in [0, bound) (Lemire's multiply-and-reject)
+    std::uint32_t below(std::uint32_t bound) {
+        std::uint64_t m = (next() >> 32) * bound;
+        std::uint32_t low = static_cast<std::uint32_t>(m);
+        if (low < bound) {
+            const std::uint32_t threshold = static_cast<std::uint32_t>(-bound) % bound;
+            while (low < threshold) {
+                m = (next() >> 32) * bound;
+                low = static_cast<std::uint32_t>(m);
+            }
+        }
+        return static_cast<std::uint32_t>(m >> 32);
+    }
+
+    // Equivalent to 2^128 calls to next(); used to split off non-overlapping streams
+    void jump() {
+        static constexpr std::uint64_t kJump[] = {
+            0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull,
+            0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull };
+        std::uint64_t t[4] = {0, 0, 0, 0};
+        for (std::uint64_t mask : kJump) {
+            for (int b = 0; b < 64; ++b) {
+                if (mask & (1ull << b)) {
+                    for (int i = 0; i < 4; ++i) t[i] ^= s[i];
+                }
+                next();
+            }
+        }
+        for (int i = 0; i < 4; ++i) s[i] = t[i];
+    }
+
+    const std::uint64_t* state() const { return s; }
+
+private:
+    static std::uint64_t rotl(std::uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+    std::uint64_t s[4];
+};
@@ -0,0 +1,114 @@
+// Solver.hpp
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Deadlock.hpp"
+#include "Puzzle.hpp"
+
+// --- Push-optimal puzzle solver ---
+// Searches over pushes only: between two pushes the player is somewhere in its
+// reachable region, and a state stores the smallest reachable cell as the
+// player position, so walking around never creates new states. States are
+// keyed by a Zobrist hash (boxes + normalized player) in a transposition table.
+// Push distances are precomputed per goal by pulling a box away from it; cells
+// no goal can be pulled to are dead squares and never receive a box, and a
+// push that freezes a box off its goal is pruned (DeadlockTable). The
+// heuristic is a minimum-cost box-to-goal matching under standard rules (each
+// goal holds one box) and the sum of nearest-goal distances under portal rules.
+// When boxes fence off a PI-corral, only the pushes into it are searched.
+enum class SearchAlgorithm : std::uint8_t {
+    AStar,   // best-first, exact duplicate detection; memory grows with the search
+    IdaStar, // iterative deepening on f; fixed-size lock-free transposition table, can run in parallel
+};
+
+struct SolverOptions {
+    SearchAlgorithm algorithm = SearchAlgorithm::AStar;
+    std::uint64_t maxNodes = 300000;   // give up after this many expansions: seconds, even on a hard level
+    int tableBits = 22;                // IDA*: at most 2^bits transposition entries, grown as the search needs
+
+    // IDA* worker threads. 1 is the deterministic sequential search (same nodes,
+    // same solution every run); 0 uses every hardware thread.
+    int threads = 1;
+};
+
+struct SolverResult {
+    bool solved = false;
+    bool unsolvable = false; // search space exhausted without a solution
+    int pushes = 0;
+    std::string solution;    // LURD: lowercase = walk, uppercase = push
+    std::uint64_t nodes = 0; // states expanded
+    double seconds = 0.0;
+    int threads = 1;
+
+    double nodesPerSecond() const { return seconds > 0.0 ? nodes / seconds : 0.0; }
+};
+
+class Solver {
+public:
+    explicit Solver(const PuzzleLevel& level);
+    ~Solver();
+
+    Solver(const Solver&) = delete;
+    Solver& operator=(const Solver&) = delete;
+
+    SolverResult solve(const SolverOptions& options = SolverOptions());
+
+    // Push distance from a cell to the nearest goal; -1 for walls and dead squares
+    int pushDistance(int x, int y) const;
+
+private:
+    struct Push {
+        int box;  // index into the box list
+        int dir;  // 0..3 (up, down, left, right)
+    };
+    struct Assignment; // box-to-goal matching and its dual potentials (Solver.cpp)
+    struct Worker;     // per-thread search state (Solver.cpp)
+    struct IdaShared;  // one IDA* iteration shared by all workers (Solver.cpp)
+    struct IdaPool;    // threads kept for every iteration of one solve (Solver.cpp)
+
+    // Internal cells carry a one-cell wall border, so neighbor offsets never leave the grid
+    int cellOf(int levelCell) const;
+
+    void computeDistances();
+    void pullFrom(int goal, std::vector<int>& out);
+    int reach(Worker& w, int from) const; // marks reachable cells, returns the smallest
+    void collectPushes(Worker& w, std::vector<Push>& out) const; // uses the last reach()
+    void restrictToCorral(Worker& w, std::vector<Push>& pushes) const;
+    std::uint64_t boxHashOf(const int* cells, int count) const;
+    // Lower bound on the pushes left; kInfinite if some box can't get a goal
+    int heuristicOf(Worker& w, Assignment& a, const int* cells, int count) const;
+    // Same after box 'moved' was pushed, repairing the parent's matching into 'a'
+    int heuristicAfterPush(Worker& w, const Assignment& parent, Assignment& a, const int* cells, int count, int moved) const;
+    bool augment(Worker& w, Assignment& a, const int* cells, int row) const;
+    int nearestGoalSum(const int* cells, int count) const;
+    bool consumes(int cell) const;
+
+    SolverResult solveAStar(const SolverOptions& options);
+    SolverResult solveIdaStar(const SolverOptions& options);
+    void runIdaThread(int index, IdaPool& pool);
+    void runIdaWorker(int index, IdaShared& shared);
+    bool idaSearch(Worker& w, int g, IdaShared& shared);
+    std::string toLurd(const std::vector<std::pair<int, int>>& pushes) const; // (box cell, dir)
+
+    PuzzleRules rules;
+    int levelWidth;
+    int width;  // levelWidth + 2
+    int height; // level height + 2
+    int offsets[4];
+    std::vector<std::uint8_t> walls;
+    std::vector<std::uint8_t> goals;
+    DeadlockTable deadlocks;            // dead squares and freeze tests on the bordered grid
+    std::vector<int> distance;          // push distance to the nearest goal, kInfinite if dead
+    std::vector<int> goalCells;
+    std::vector<std::vector<int>> goalDistance; // per goal, push distance from every cell
+    std::vector<std::uint64_t> boxKeys;
+    std::vector<std::uint64_t> playerKeys;
+    std::vector<int> startBoxes;
+    int startPlayer;
+
+    std::vector<std::unique_ptr<Worker>> workers; // [0] also runs A*
+};
@@ -0,0 +1,60 @@
+// TextureAtlas.hpp
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <cstdint>
+#include <string>
+
+// --- AtlasImage: every picture the game draws, packed into one texture ---
+enum class AtlasImage : std::uint8_t {
+    Box,        // pushable box
+    SpecialBox, // immovable box
+    Portal,
+    Player1,
+    Player2,
+    Wall,
+    SnowWall,
+    Bomb,
+    White,      // solid white cell, used for flat-colored quads (floor, fallbacks)
+    Count
+};
+
+constexpr int kAtlasImageCount = static_cast<int>(AtlasImage::Count);
+
+// File names of the packed atlas inside the asset directory (written by --pack-atlas)
+constexpr const char* kPackedAtlasImage = "atlas.png";
+constexpr const char* kPackedAtlasTable = "atlas.txt";
+
+// --- TextureAtlas: packs all tile and player images into a single texture ---
+// Each source image is resampled (box filter) into a fixed-size cell of one
+// sf::Image, so the whole board and both players share one texture bind.
+// pack() decodes the original assets; savePacked()/loadPacked() cache the
+// result as one PNG plus a text UV table so startup can skip the JPEG decodes.
+class TextureAtlas {
+public:
+    static constexpr unsigned kCellSize = 64; // pixels per packed image (tiles are drawn at ~37 px)
+
+    // Decode and pack the source images from assetDir; false if a required image is missing
+    bool pack(const std::string& assetDir);
+
+    // Write/read the packed atlas (image + "name x y w h" table)
+    bool savePacked(const std::string& imagePath, const std::string& tablePath) const;
+    bool loadPacked(const std::string& imagePath, const std::string& tablePath);
+
+    // Load <assetDir>/atlas.png + atlas.txt if present, otherwise pack the source images
+    bool loadOrPack(const std::string& assetDir);
+
+    // Upload the packed image to the GPU (needs a GL context)
+    bool upload();
+
+    const sf::Texture& texture() const { return tex; }
+    const sf::Image& image() const { return atlas; }
+    sf::IntRect rect(AtlasImage id) const { return rects[static_cast<std::size_t>(id)]; }
+
+    static const char* name(AtlasImage id);
+
+private:
+    sf::Image atlas;
+    sf::Texture tex;
+    std::array<sf::IntRect, kAtlasImageCount> rects{};
+};
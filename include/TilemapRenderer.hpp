@@ -0,0 +1,73 @@
+// TilemapRenderer.hpp
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "World.hpp"
+
+// --- TilemapRenderer: draws the whole board in two draw calls ---
+// The checkerboard floor never changes during a level, so it is rendered once
+// into a cached sf::RenderTexture and blitted as a single sprite. Everything
+// else (boxes, portals) lives in one compact vertex list textured from the
+// shared atlas: each non-floor cell owns six vertices, and a tile change only
+// rewrites, appends or swap-removes that cell's quad. The floor cache is
+// rebuilt only when the level (layout version or size) changes.
+class TilemapRenderer : public sf::Drawable {
+public:
+    // atlas must outlive the renderer
+    TilemapRenderer(float tileSize, const sf::Texture& atlas);
+
+    // Per-kind look: atlas region, quad edge length in pixels, and vertex color (tint)
+    void setStyle(TileType kind, const sf::IntRect& texRect, float size,
+                  const sf::Color& color = sf::Color::White);
+
+    // Floor quads are tinted as a checkerboard of these two colors
+    void setFloorColors(const sf::Color& dark, const sf::Color& light);
+
+    // Bring the board up to date: full rebuild (including the floor cache) when
+    // the level changed, otherwise only the cells listed in world.changedCells()
+    void sync(const World& world);
+
+    int drawCalls() const { return lastDrawCalls; }
+    int floorCacheBuilds() const { return cacheBuilds; }
+
+private:
+    struct Style {
+        sf::IntRect texRect;
+        float size = 0.f;
+        sf::Color color = sf::Color::White;
+    };
+
+    void rebuild(const World& world);
+    void buildFloor();
+    void writeCell(int cell, TileType kind);
+    void removeEntity(int cell);
+
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+    float tile;
+    const sf::Texture* texture;
+    int width = 0;
+    int height = 0;
+    std::uint64_t builtVersion = ~0ull;
+    std::array<Style, kTileTypeCount> styles;
+    sf::Color floorDark;
+    sf::Color floorLight;
+
+    // Static layer: floor quads, cached in a render texture when it fits on the GPU
+    std::vector<sf::Vertex> floorVertices;
+    sf::RenderTexture floorCache;
+    std::optional<sf::Sprite> floorSprite; // empty => draw floorVertices directly
+    int cacheBuilds = 0;
+
+    // Dynamic layer: one quad per non-floor cell, packed densely
+    std::vector<sf::Vertex> entityVertices;
+    std::vector<int> entitySlot;   // per cell: slot in the entity list, -1 if floor
+    std::vector<int> entityCell;   // per slot: owning cell
+    std::vector<TileType> shown;   // kind each cell is currently drawn as
+
+    mutable int lastDrawCalls = 0;
+};
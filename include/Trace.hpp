@@ -0,0 +1,106 @@
+// Trace.hpp
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// --- Trace events in Chrome trace format (chrome://tracing, ui.perfetto.dev) ---
+// Where Profiler keeps per-phase aggregates, this records individual events so
+// a single long frame can be taken apart afterwards.
+//
+//   TRACE_SCOPE("name")          duration event for the enclosing scope
+//   TRACE_INSTANT("name")        point event (e.g. "portal consume")
+//   TRACE_COUNTER("name", value) counter track
+//
+// Names must be string literals (only the pointer is stored). Each thread
+// writes into its own fixed ring of kEventsPerThread events with no locks and
+// no allocation after its first event; trace::flush() can run from any thread.
+// While tracing is off every macro is one relaxed atomic load; building with
+// SOKUBAN_NO_TRACE removes them entirely.
+namespace trace {
+
+enum class EventType : std::uint8_t { Complete, Instant, Counter };
+
+struct Event {
+    const char* name;
+    std::uint64_t startNs; // since trace::start()
+    std::uint64_t durationNs;
+    std::int64_t value;
+    EventType type;
+};
+
+constexpr int kEventsPerThread = 1 << 16;
+constexpr int kMaxThreads = 64;
+
+namespace detail {
+extern std::atomic<bool> enabledFlag;
+// trace::start() time in steady_clock ticks; atomic since start() may run while
+// other threads are already recording
+extern std::atomic<std::chrono::steady_clock::rep> epochTicks;
+
+void record(const Event& ev);
+
+inline std::uint64_t nowNs() {
+    using Clock = std::chrono::steady_clock;
+    const Clock::duration sinceStart =
+        Clock::now().time_since_epoch() - Clock::duration(epochTicks.load(std::memory_order_relaxed));
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(sinceStart).count());
+}
+} // namespace detail
+
+inline bool enabled() { return detail::enabledFlag.load(std::memory_order_relaxed); }
+
+// Start recording (clears nothing: events from earlier sessions stay in the rings)
+void start();
+void stop();
+
+// Label the calling thread in the trace viewer (copied, up to 31 chars). Only
+// takes effect before the thread's first event; later calls are ignored.
+void setThreadName(const char* name);
+
+// Write every thread's buffered events as Chrome trace JSON; false if the file can't be opened.
+// Threads keep recording meanwhile; only events still being written may be skipped.
+bool flush(const char* path);
+
+inline void instant(const char* name) {
+    if (enabled()) detail::record({ name, detail::nowNs(), 0, 0, EventType::Instant });
+}
+
+inline void counter(const char* name, std::int64_t value) {
+    if (enabled()) detail::record({ name, detail::nowNs(), 0, value, EventType::Counter });
+}
+
+class Scope {
+public:
+    explicit Scope(const char* name)
+    : name(enabled() ? name : nullptr)
+    {
+        if (this->name) startNs = detail::nowNs();
+    }
+
+    ~Scope() {
+        if (name) detail::record({ name, startNs, detail::nowNs() - startNs, 0, EventType::Complete });
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    const char* name;
+    std::uint64_t startNs = 0;
+};
+
+} // namespace trace
+
+#define SOKUBAN_TRACE_CAT2(a, b) a##b
+#define SOKUBAN_TRACE_CAT(a, b) SOKUBAN_TRACE_CAT2(a, b)
+
+#ifdef SOKUBAN_NO_TRACE
+#define TRACE_SCOPE(name) ((void)0)
+#define TRACE_INSTANT(name) ((void)0)
+#define TRACE_COUNTER(name, value) ((void)0)
+#else
+#define TRACE_SCOPE(name) ::trace::Scope SOKUBAN_TRACE_CAT(traceScope_, __LINE__)(name)
+#define TRACE_INSTANT(name) ::trace::instant(name)
+#define TRACE_COUNTER(name, value) ::trace::counter(name, static_cast<std::int64_t>(value))
+#endif
@@ -0,0 +1,93 @@
+// VecWorld.hpp
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "InputQueue.hpp"
+#include "World.hpp"
+
+// --- Batched environment: N independent matches stepped by one call ---
+// Each match is a BasicWorld, so moves, pushes, portals and spawns follow the
+// exact game rules. Everything a trainer exchanges with the batch lives in
+// flat structure-of-arrays buffers owned here: the caller writes actions in
+// place, step() advances every match, and observations, rewards and done flags
+// are read in place with no copy. A finished match reports done and restarts
+// at once as the next episode of its seed (World::restart). Steady-state steps
+// do not allocate. Actions are MoveDir values, one byte per player per match.
+// Matches are stepped one after another, not across SIMD lanes: the rules
+// branch on every move. The batch scales with threads.
+
+
+template <class Board>
+class BasicVecWorld {
+public:
+    // Observation planes per match, kPlanes * width * height bytes, 0 or 1
+    enum Plane { kPlaneWalls, kPlaneBoxes, kPlanePortals, kPlanePlayer1, kPlanePlayer2, kPlanes };
+
+    // 'count' matches sharing 'config'; match i starts from seed config.seed + i.
+    // 'threads' workers split the batch on every step (0 = every hardware thread).
+    BasicVecWorld(int count, const WorldConfig& config = WorldConfig(), int threads = 1);
+    ~BasicVecWorld();
+
+    BasicVecWorld(const BasicVecWorld&) = delete;
+    BasicVecWorld& operator=(const BasicVecWorld&) = delete;
+
+    int size() const { return count; }
+    int width() const { return worlds.front().width(); }
+    int height() const { return worlds.front().height(); }
+    int threadCount() const { return threads; }
+
+    // Restart every match from its first seed
+    void reset();
+
+    // Apply actions() to every match and advance them all by one tick
+    void step();
+
+    // --- Buffers (valid for the lifetime of the batch) ---
+    std::uint8_t* actions() { return actionBuf.data(); }             // [match * 2 + player], MoveDir
+    const std::uint8_t* observations() const { return obsBuf.data(); } // [match][plane][y][x]
+    const float* rewards() const { return rewardBuf.data(); }        // [match * 2 + player], points this step
+    const std::uint8_t* dones() const { return doneBuf.data(); }     // [match], 1 = ended this step, next episode started
+
+    std::size_t observationSize() const { return obsStride; } // bytes per match
+
+    const BasicWorld<Board>& world(int match) const { return worlds[static_cast<std::size_t>(match)]; }
+
+private:
+    struct Pool; // persistent workers for step() (VecWorld.cpp)
+
+    void stepRange(int begin, int end);
+    void writeObservation(int match);  // whole match, after a restart
+    void updateObservation(int match); // changed cells and players only
+    void runWorker(int index);
+
+    int count;
+    int threads;
+    std::vector<BasicWorld<Board>> worlds;
+    std::vector<std::uint64_t> episodes; // per match, restarts so far (picks the next stream)
+
+    std::vector<std::uint8_t> actionBuf;
+    std::vector<std::uint8_t> obsBuf;
+    std::vector<float> rewardBuf;
+    std::vector<std::uint8_t> doneBuf;
+    std::size_t obsStride;
+
+    // What each observation currently shows, for incremental updates. Updated on
+    // most steps, so each match gets its own cache line: neighbors may belong to
+    // another thread's slice.
+    struct alignas(64) Shown {
+        std::uint64_t layout = 0;     // World::layoutVersion()
+        int playerCell[2] = { 0, 0 }; // map cell y * width + x
+    };
+    std::vector<Shown> shown; // [match]
+
+    std::unique_ptr<Pool> pool; // only with more than one thread
+};
+
+// Definitions live in VecWorld.cpp, instantiated for these boards only
+extern template class BasicVecWorld<DynamicBoard>;
+extern template class BasicVecWorld<FixedBoard<32, 18>>;
+
+using VecWorld = BasicVecWorld<DynamicBoard>;
+using VecWorld32x18 = BasicVecWorld<FixedBoard<32, 18>>;
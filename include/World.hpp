@@ -0,0 +1,281 @@
+// World.hpp
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Deadlock.hpp"
+#include "Profiler.hpp"
+#include "Rng.hpp"
+
+// --- Headless simulation core ---
+// Owns every game rule (map, pushing, portal scoring, spawner, match timer).
+// Nothing in here depends on SFML, so the same engine drives the windowed
+// game, bots, replays and load tests on machines without a display.
+
+// --- TileType: one byte per cell; drawing data is kept by the client, per kind ---
+enum class TileType : std::uint8_t {
+    Floor,       // walkable
+    Box,         // blocking tile (immovable)
+    PushableBox, // a box that players can push one tile at a time
+    Portal,      // special floor tile that 'consumes' a pushable box and awards points
+    Count
+};
+
+constexpr int kTileTypeCount = static_cast<int>(TileType::Count);
+
+// --- TileTraits: per-kind behavior, looked up by tag instead of virtual calls ---
+struct TileTraits {
+    bool walkable;       // a player may step onto it
+    bool pushable;       // a player walking into it shoves it one cell
+    bool consumesBox;    // a box pushed onto it disappears
+    TileType boxLandsAs; // what the cell becomes when a box is pushed onto it (Count => box is blocked)
+    int scoreValue;      // points awarded to the pusher when a box lands here
+};
+
+constexpr TileTraits kTileTraits[kTileTypeCount] = {
+    /* Floor       */ { true,  false, false, TileType::PushableBox, 0  },
+    /* Box         */ { false, false, false, TileType::Count,       0  },
+    /* PushableBox */ { false, true,  false, TileType::Count,       0  },
+    /* Portal      */ { true,  false, true,  TileType::Portal,      10 },
+};
+
+constexpr const TileTraits& traitsOf(TileType t) { return kTileTraits[static_cast<int>(t)]; }
+
+// --- Per-tick input: one intended step per player (dx, dy in -1..1) ---
+struct PlayerInput {
+    int dx = 0;
+    int dy = 0;
+};
+
+struct Inputs {
+    PlayerInput player[2];
+};
+
+// --- Match settings; all durations are expressed in simulation ticks ---
+struct WorldConfig {
+    int width = 16 * 2;
+    int height = 9 * 2;
+    int tickRate = 60;            // ticks per simulated second (input is sampled every tick)
+    int gameDurationSec = 60;     // 1 min match
+    int spawnIntervalTicks = 120; // one box every 2 s
+    int moveIntervalTicks = 6;    // a held direction steps 10 cells per second
+    std::uint64_t seed = 1;      // spawner RNG seed; same seed + same inputs => same match
+    std::uint64_t stream = 0;    // independent RNG stream for parallel matches sharing a seed (cost grows with k, paid once per seed)
+
+    // Same match pacing (2 s spawns, 10 steps/s) at another tick rate
+    static WorldConfig forTickRate(int hz) {
+        WorldConfig c;
+        c.tickRate = hz;
+        c.spawnIntervalTicks = 2 * hz;
+        c.moveIntervalTicks = hz >= 10 ? hz / 10 : 1;
+        return c;
+    }
+};
+
+// --- Board dimensions: a policy for BasicWorld ---
+// DynamicBoard takes width and height from the WorldConfig and keeps the grids
+// on the heap. FixedBoard<W, H> makes them compile-time constants: cell
+// indices and neighbor offsets fold to immediates, and the grids are arrays
+// inside the world object (the DeadlockTable still owns its buffers,
+// allocated once on construction).
+struct DynamicBoard {
+    template <class T> using Grid = std::vector<T>; // one slot per bordered cell
+    template <class T> using List = std::vector<T>; // at most one entry per map cell
+
+    static int width(int configured) { return configured; }
+    static int height(int configured) { return configured; }
+};
+
+// Fixed-capacity stand-ins for std::vector, covering what the world uses
+template <class T, std::size_t N>
+class FixedGrid : public std::array<T, N> {
+public:
+    void assign(std::size_t, const T& value) { this->fill(value); }
+};
+
+template <class T, std::size_t N>
+class FixedList {
+public:
+    void reserve(std::size_t) {}
+    void clear() { count = 0; }
+    void push_back(const T& value) { items[count++] = value; }
+    void pop_back() { --count; }
+    T& back() { return items[count - 1]; }
+    T& operator[](std::size_t i) { return items[i]; }
+    const T& operator[](std::size_t i) const { return items[i]; }
+    bool empty() const { return count == 0; }
+    std::size_t size() const { return count; }
+    const T* begin() const { return items.data(); }
+    const T* end() const { return items.data() + count; }
+
+private:
+    std::array<T, N> items;
+    std::size_t count = 0;
+};
+
+template <int W, int H>
+struct FixedBoard {
+    static_assert(W > 0 && H > 0, "board needs at least one cell");
+    template <class T> using Grid = FixedGrid<T, static_cast<std::size_t>((W + 2) * (H + 2))>;
+    template <class T> using List = FixedList<T, static_cast<std::size_t>(W * H)>;
+
+    static constexpr int width(int) { return W; }
+    static constexpr int height(int) { return H; }
+};
+
+struct PlayerState {
+    int x = 0;
+    int y = 0;
+    int score = 0;
+    std::uint64_t nextMoveTick = 0; // earliest tick at which this player may step again
+};
+
+// The match itself. 'Board' fixes how the grid is sized (see DynamicBoard);
+// World is the runtime-sized one every tool and the game use, World32x18 the
+// shipped map specialized at compile time. A fixed board overrides the
+// config's width and height.
+template <class Board>
+class BasicWorld {
+public:
+    explicit BasicWorld(const WorldConfig& config = WorldConfig());
+
+    // Rebuild the default level and restart the match (RNG restarts from the current episode's stream)
+    void reset();
+
+    // Change the seed and restart the match
+    void reseed(std::uint64_t seed);
+
+    // Start episode 'episode' of the current seed: a new match whose spawner
+    // stream is forked from the expanded (seed, stream) state, so it costs no
+    // jumps. Episode 0 is the seed's own match; reset() replays the current one.
+    void restart(std::uint64_t episode);
+
+    // Advance the simulation by exactly one tick
+    void step(const Inputs& inputs);
+
+    // --- Level editing (scenario setup for tools, benchmarks and custom levels) ---
+    // Both keep the free-cell index and change tracking in sync.
+    void setTileAt(int x, int y, TileType t);
+    void placePlayer(int index, int x, int y);
+
+    // Optional: time the Moves/Spawn phases of step() (nullptr disables, the default)
+    void setProfiler(Profiler* p) { profiler = p; }
+
+    int width() const { return Board::width(config.width); }
+    int height() const { return Board::height(config.height); }
+    const WorldConfig& getConfig() const { return config; }
+
+    // --- Cells: the grid is stored with a one-cell ring of Box tiles around the
+    // map, so every map cell has four neighbors and moves need no bounds checks.
+    // Cell ids (changedCells(), frozenBoxes(), deadlockTable(), tileData()) index
+    // that bordered grid: stride() cells per row, map cell (x, y) at cellAt(x, y).
+    int stride() const { return width() + 2; }
+    int cellAt(int x, int y) const { return (y + 1) * stride() + x + 1; }
+    int cellX(int cell) const { return cell % stride() - 1; }
+    int cellY(int cell) const { return cell / stride() - 1; }
+
+    TileType tileAt(int x, int y) const { return tiles[cellAt(x, y)]; }
+
+    // Row-major view of the bordered grid (stride() * (height() + 2) bytes)
+    const TileType* tileData() const { return tiles.data(); }
+
+    // --- Change tracking for renderers ---
+    // Cells whose tile changed since the last clearChangedCells() (each listed once).
+    // layoutVersion() bumps on reset(), meaning "everything changed".
+    const typename Board::template List<int>& changedCells() const { return changed; }
+    void clearChangedCells();
+    std::uint64_t layoutVersion() const { return layoutGen; }
+
+    const PlayerState& player(int index) const { return players[index]; }
+
+    // true if a step requested in the next step() call would not be held back by the move cooldown
+    bool readyToMove(int index) const { return tickCount + 1 >= players[index].nextMoveTick; }
+
+    // true if this player's step in the last step() call was cancelled because both
+    // players went for the same tile or tried to swap (not when a wall or box refused it)
+    bool moveCancelled(int index) const { return cancelled[index]; }
+
+    // Number of cells a box could spawn into right now (floor, no player, not a dead square)
+    int freeCellCount() const { return static_cast<int>(freeCells.size()); }
+
+    // --- Deadlock tables (O(1) queries for bots, tools and the spawner) ---
+    // Dead squares come from the static layout (Box tiles, portals, map edge) and
+    // are rebuilt with it. Frozen boxes can never move again; they are updated
+    // after every push, spawn and edit around the cells involved.
+    bool isDeadSquare(int x, int y) const { return deadlocks.isDead(cellAt(x, y)); }
+    bool isFrozenBox(int x, int y) const { return frozen.test(cellAt(x, y)); }
+    const DeadlockTable& deadlockTable() const { return deadlocks; }
+    const CellBitset& frozenBoxes() const { return frozen; }
+
+    // --- State hash (replays, rollback, caching, desync detection) ---
+    // 64-bit Zobrist fingerprint of the tiles, both player positions, both
+    // scores and the spawner's RNG state, updated in O(1) by every push, spawn,
+    // portal consume and edit. Keys are derived from the cell, not drawn per
+    // world, so equal states hash equal across worlds of the same size.
+    std::uint64_t stateHash() const { return hash; }
+
+    // The same value recomputed from scratch (O(cells)), for checks
+    std::uint64_t computeStateHash() const;
+
+    std::uint64_t tick() const { return tickCount; }
+    int remainingSeconds() const;
+    bool isGameOver() const { return gameOver; }
+
+    // 0 = draw, 1 = player 1, 2 = player 2 (only meaningful once the game is over)
+    int winner() const;
+
+private:
+    bool isPlayerAt(int cell) const;
+    void refreshFreeCell(int cell);
+    void rebuildFreeCells();
+    void rebuildDeadlocks();
+    bool retestFrozen(int cell);
+    void refreshFrozenAround(int cell);
+    void spreadFrozen(int cell, bool freezing);
+    void setTile(int cell, TileType t);
+    void spawnBox();
+    void tryMovePlayer(int playerIndex, int dx, int dy);
+
+    template <class T> using Grid = typename Board::template Grid<T>;
+    template <class T> using List = typename Board::template List<T>;
+
+    WorldConfig config;
+    Grid<TileType> tiles; // bordered row-major grid, one contiguous block
+
+    // Free-cell index for the spawner: dense list of spawnable cells plus each
+    // cell's slot in that list (-1 when not free), so insert/remove/pick are O(1)
+    List<int> freeCells;
+    Grid<int> freeSlot;
+
+    // Deadlock state: static flags fed to the table, box occupancy and frozen boxes.
+    // With no live square at all (no reachable portal) the spawner ignores dead squares.
+    DeadlockTable deadlocks;
+    Grid<std::uint8_t> board;
+    CellBitset boxes;
+    CellBitset frozen;
+    bool spawnAvoidsDead = false;
+
+    List<int> changed;                 // cells touched since the last clear
+    Grid<std::uint8_t> changedFlag;    // 1 => already in 'changed'
+    std::uint64_t layoutGen = 0;
+
+    PlayerState players[2];
+    bool cancelled[2] = { false, false }; // moveCancelled()
+    Rng rng;
+    Rng seedRng;  // (config.seed, config.stream) expanded once
+    Rng startRng; // seedRng forked for the current episode; reset() restarts from a copy
+    std::uint64_t hash = 0; // stateHash()
+    std::uint64_t tickCount = 0;
+    std::uint64_t lastSpawnTick = 0;
+    bool gameOver = false;
+    Profiler* profiler = nullptr;
+};
+
+// Definitions live in World.cpp, instantiated for these boards only
+extern template class BasicWorld<DynamicBoard>;
+extern template class BasicWorld<FixedBoard<32, 18>>;
+
+using World = BasicWorld<DynamicBoard>;
+using World32x18 = BasicWorld<FixedBoard<32, 18>>; // WorldConfig's default size